@@ -0,0 +1,55 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "bench/AllocationCounter.h"
+
+// Replaces the plain, array and sized forms of the global allocation functions with a matched set which counts every
+// allocation. They are kept in their own file so the compiler can't inline a free() into code it sees calling
+// operator new. The nothrow forms of the standard library call these, and the aligned forms aren't counted.
+
+namespace {
+
+std::atomic<long long> num_allocations{0};
+
+void* CountedAllocate(std::size_t size) {
+    ++num_allocations;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+} // End anonymous namespace
+
+namespace Bench {
+
+long long NumAllocations() {
+    return num_allocations;
+}
+
+} // End namespace Bench
+
+void* operator new(std::size_t size) {
+    return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return CountedAllocate(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace Bench {
+
+// The number of allocations made through the global operator new and operator new[] so far. Only counted in
+// programs linked with AllocationCounter.cpp, which replaces them.
+long long NumAllocations();
+
+} // End namespace Bench
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <iostream>
+#include <iomanip>
+#include <unordered_map>
+
+#include "bench/BenchUtil.h"
+
+namespace Bench {
+
+Timings TimeIterations(int iterations, const std::function<void()>& func) {
+    std::vector<double> times;
+    for (int i = 0; i < iterations; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const auto end = std::chrono::steady_clock::now();
+
+        times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    return SummarizeTimes(times);
+}
+
+Timings SummarizeTimes(std::vector<double> times) {
+    if (times.empty()) {
+        return {0.0, 0.0, 0.0};
+    }
+
+    std::sort(times.begin(), times.end());
+    const std::size_t p99_index = std::min(times.size() - 1, times.size() * 99 / 100);
+
+    return {times.front(), times[times.size() / 2], times[p99_index]};
+}
+
+void PrintTimings(const std::string& label, const Timings& timings) {
+    std::cout << std::left << std::setw(40) << label << std::right << std::fixed << std::setprecision(3)
+              << " min " << std::setw(10) << timings.min << " ms"
+              << "  median " << std::setw(10) << timings.median << " ms"
+              << "  p99 " << std::setw(10) << timings.p99 << " ms\n";
+}
+
+std::vector<tinyobj::mesh_t> LoadObjMeshes(const std::string& obj_filename, int& num_vertices) {
+    tinyobj::attrib_t attributes;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+
+    std::string err_msg;
+    bool success = tinyobj::LoadObj(&attributes, &shapes, &materials, &err_msg, obj_filename.c_str(), nullptr, false);
+    if (!success) {
+        throw std::runtime_error("Error when attempting to load mesh from " + obj_filename);
+    }
+
+    std::vector<tinyobj::mesh_t> meshes;
+    std::transform(shapes.cbegin(), shapes.cend(), std::back_inserter(meshes),
+                   [](const tinyobj::shape_t& shape) { return shape.mesh; });
+
+    num_vertices = attributes.vertices.size() / 3;
+
+    return meshes;
+}
+
+std::vector<Subdivision::FaceDataPtr> GridFaces(int width, int height) {
+    std::vector<Subdivision::FaceDataPtr> face_data;
+    face_data.reserve(width * height);
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const int v0 = y * (width + 1) + x;
+            std::vector<int> face_indices{v0, v0 + 1, v0 + width + 2, v0 + width + 1};
+            face_data.push_back(std::make_unique<Subdivision::FaceData>(face_indices, true));
+        }
+    }
+
+    return face_data;
+}
+
+namespace {
+
+void AddObjFace(tinyobj::mesh_t& mesh, const std::vector<int>& vertices) {
+    for (const int v : vertices) {
+        mesh.indices.push_back({v, -1, -1});
+    }
+    mesh.num_face_vertices.push_back(vertices.size());
+    mesh.material_ids.push_back(-1);
+}
+
+} // End anonymous namespace
+
+Subdivision::TinyObjMesh CubeObjMesh(int size) {
+    tinyobj::attrib_t attrs;
+    tinyobj::mesh_t mesh;
+
+    // Vertices are shared between sides through their position on the (size + 1)^3 lattice.
+    std::unordered_map<long long, int> lattice_vertices;
+    auto vertex = [&](int x, int y, int z) {
+        const long long key = (static_cast<long long>(x) * (size + 1) + y) * (size + 1) + z;
+        const auto insert = lattice_vertices.emplace(key, lattice_vertices.size());
+        if (insert.second) {
+            for (const int c : {x, y, z}) {
+                attrs.vertices.push_back(2.0f * c / size - 1.0f);
+            }
+        }
+        return insert.first->second;
+    };
+
+    // Each side is spanned by the two axes after its normal axis, which wind counterclockwise seen from outside the
+    // cube on the positive side, and clockwise on the negative side.
+    for (int axis = 0; axis < 3; ++axis) {
+        for (const int side : {0, size}) {
+            for (int v = 0; v < size; ++v) {
+                for (int u = 0; u < size; ++u) {
+                    std::vector<int> face;
+                    for (const auto& corner : {std::make_pair(u, v), std::make_pair(u + 1, v),
+                                               std::make_pair(u + 1, v + 1), std::make_pair(u, v + 1)}) {
+                        int p[3];
+                        p[axis] = side;
+                        p[(axis + 1) % 3] = corner.first;
+                        p[(axis + 2) % 3] = corner.second;
+                        face.push_back(vertex(p[0], p[1], p[2]));
+                    }
+
+                    if (side == 0) {
+                        std::reverse(face.begin(), face.end());
+                    }
+                    AddObjFace(mesh, face);
+                }
+            }
+        }
+    }
+
+    return {attrs, {mesh}};
+}
+
+Subdivision::TinyObjMesh GridObjMesh(int width, int height, int triangle_stride) {
+    tinyobj::attrib_t attrs;
+    tinyobj::mesh_t mesh;
+
+    for (int y = 0; y <= height; ++y) {
+        for (int x = 0; x <= width; ++x) {
+            attrs.vertices.insert(attrs.vertices.end(), {static_cast<float>(x), static_cast<float>(y), 0.0f});
+        }
+    }
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const int v0 = y * (width + 1) + x;
+            const int v1 = v0 + 1, v2 = v0 + width + 2, v3 = v0 + width + 1;
+            if (x % triangle_stride == 0 && y % triangle_stride == 0) {
+                AddObjFace(mesh, {v0, v1, v2});
+                AddObjFace(mesh, {v0, v2, v3});
+            } else {
+                AddObjFace(mesh, {v0, v1, v2, v3});
+            }
+        }
+    }
+
+    return {attrs, {mesh}};
+}
+
+} // End namespace Bench
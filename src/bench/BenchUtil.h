@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <functional>
+
+#include "externals/tiny_obj_loader.h"
+#include "subdivision/Connectivity.h"
+#include "subdivision/ObjMesh.h"
+
+namespace Bench {
+
+// Wall clock times of repeated runs of a benchmark, in milliseconds.
+struct Timings {
+    double min, median, p99;
+};
+
+Timings TimeIterations(int iterations, const std::function<void()>& func);
+// The timings of a list of run times in milliseconds, for benchmarks which time parts of each run themselves.
+Timings SummarizeTimes(std::vector<double> times);
+void PrintTimings(const std::string& label, const Timings& timings);
+
+// Loads the faces of an .obj file, and returns the number of vertices through num_vertices.
+std::vector<tinyobj::mesh_t> LoadObjMeshes(const std::string& obj_filename, int& num_vertices);
+
+// A flat width x height grid of counterclockwise quads, with (width + 1) * (height + 1) vertices.
+std::vector<Subdivision::FaceDataPtr> GridFaces(int width, int height);
+
+// The surface of a cube with each side split into size x size quads. All vertices are regular except for the eight
+// corners, which have valence 3.
+Subdivision::TinyObjMesh CubeObjMesh(int size);
+
+// A flat width x height grid of quads, with every cell whose x and y are multiples of triangle_stride split into two
+// triangles. Each split adds two extraordinary vertices, so the stride sets how much of the grid needs refining.
+Subdivision::TinyObjMesh GridObjMesh(int width, int height, int triangle_stride);
+
+} // End namespace Bench
@@ -0,0 +1,112 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench/BenchUtil.h"
+#include "subdivision/HalfEdge.h"
+
+// Times building the base mesh connectivity (half-edges, vertex valences and B-spline control points) on an
+// increasing number of threads, and checks that every thread count gives the same result as one thread.
+// Usage: connectivity_bench [iterations] [max_threads] [model.obj ...]
+
+namespace {
+
+struct Connectivity {
+    Subdivision::HalfEdgeMesh mesh;
+    std::vector<Subdivision::FaceDataPtr> face_data;
+};
+
+Connectivity BuildConnectivity(const std::vector<Subdivision::FaceDataPtr>& faces, int num_vertices, int num_threads) {
+    Connectivity result;
+    result.face_data.reserve(faces.size());
+    for (const auto& face : faces) {
+        result.face_data.push_back(std::make_unique<Subdivision::FaceData>(face->vertices, face->Valence() == 4));
+    }
+
+    result.mesh = Subdivision::GenerateHalfEdgeMesh(result.face_data, num_vertices, Subdivision::EdgePairing::RadixSort,
+                                                 num_threads);
+    Subdivision::GenerateHalfEdgeVertexConnectivity(result.mesh, result.face_data, num_threads);
+    Subdivision::GenerateControlPoints(result.mesh, result.face_data, num_threads);
+
+    return result;
+}
+
+bool SameConnectivity(const Connectivity& a, const Connectivity& b) {
+    if (a.mesh.twin != b.mesh.twin || a.mesh.vertex_edge != b.mesh.vertex_edge
+            || a.mesh.vertex_valence != b.mesh.vertex_valence
+            || a.mesh.vertex_boundary_edges != b.mesh.vertex_boundary_edges) {
+        return false;
+    }
+
+    for (std::size_t f = 0; f < a.face_data.size(); ++f) {
+        const auto& face_a = *a.face_data[f];
+        const auto& face_b = *b.face_data[f];
+        if (face_a.regular != face_b.regular || face_a.vertex_valences != face_b.vertex_valences
+                || face_a.regular_corners != face_b.regular_corners || face_a.control_points != face_b.control_points) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void BenchConnectivity(const std::string& name, const std::vector<Subdivision::FaceDataPtr>& faces, int num_vertices,
+                       int iterations, int max_threads) {
+    std::cout << name << ": " << faces.size() << " faces, " << num_vertices << " vertices\n";
+
+    const Connectivity serial{BuildConnectivity(faces, num_vertices, 1)};
+    double serial_median = 0.0;
+
+    for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        if (!SameConnectivity(serial, BuildConnectivity(faces, num_vertices, num_threads))) {
+            std::cout << "  Connectivity on " << num_threads << " threads differs from one thread!\n";
+        }
+
+        const auto timings = Bench::TimeIterations(iterations, [&]() {
+            BuildConnectivity(faces, num_vertices, num_threads);
+        });
+        if (num_threads == 1) {
+            serial_median = timings.median;
+        }
+
+        Bench::PrintTimings("  " + std::to_string(num_threads) + " threads", timings);
+        std::cout << "  speedup (median): " << serial_median / timings.median << "x\n";
+    }
+}
+
+} // End anonymous namespace
+
+int main(int argc, char** argv) {
+    int iterations = 10;
+    int max_threads = 16;
+    std::vector<std::string> models{"../models/bigguy.obj", "../models/monsterfrog.obj"};
+
+    if (argc > 1) {
+        iterations = std::stoi(argv[1]);
+    }
+    if (argc > 2) {
+        max_threads = std::stoi(argv[2]);
+    }
+    if (argc > 3) {
+        models.assign(argv + 3, argv + argc);
+    }
+
+    try {
+        for (const auto& model : models) {
+            int num_vertices;
+            const auto meshes = Bench::LoadObjMeshes(model, num_vertices);
+            BenchConnectivity(model, Subdivision::GenerateFaceConnectivity(meshes), num_vertices, iterations,
+                              max_threads);
+        }
+
+        for (const int size : {316, 1000, 2000}) {
+            BenchConnectivity("grid " + std::to_string(size) + "x" + std::to_string(size),
+                              Bench::GridFaces(size, size), (size + 1) * (size + 1), iterations, max_threads);
+        }
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench/BenchUtil.h"
+#include "subdivision/HalfEdge.h"
+
+// Compares finding twin half-edges with an unordered_map against radix sorting packed edge keys.
+// Usage: edge_pairing_bench [iterations] [model.obj ...]
+
+namespace {
+
+void BenchEdgePairing(const std::string& name, const std::vector<Subdivision::FaceDataPtr>& face_data,
+                      int num_vertices, int iterations) {
+    using Subdivision::EdgePairing;
+
+    std::cout << name << ": " << face_data.size() << " faces, " << num_vertices << " vertices\n";
+
+    const auto hash_mesh = Subdivision::GenerateHalfEdgeMesh(face_data, num_vertices, EdgePairing::HashMap);
+    const auto sort_mesh = Subdivision::GenerateHalfEdgeMesh(face_data, num_vertices, EdgePairing::RadixSort);
+    if (hash_mesh.twin != sort_mesh.twin) {
+        std::cout << "  Edge pairings differ!\n";
+    }
+
+    const auto hash_timings = Bench::TimeIterations(iterations, [&]() {
+        Subdivision::GenerateHalfEdgeMesh(face_data, num_vertices, EdgePairing::HashMap);
+    });
+    const auto sort_timings = Bench::TimeIterations(iterations, [&]() {
+        Subdivision::GenerateHalfEdgeMesh(face_data, num_vertices, EdgePairing::RadixSort);
+    });
+
+    Bench::PrintTimings("  hash map", hash_timings);
+    Bench::PrintTimings("  radix sort", sort_timings);
+    std::cout << "  speedup (median): " << hash_timings.median / sort_timings.median << "x\n";
+}
+
+} // End anonymous namespace
+
+int main(int argc, char** argv) {
+    int iterations = 10;
+    std::vector<std::string> models{"../models/bigguy.obj", "../models/monsterfrog.obj"};
+
+    if (argc > 1) {
+        iterations = std::stoi(argv[1]);
+    }
+    if (argc > 2) {
+        models.assign(argv + 2, argv + argc);
+    }
+
+    try {
+        for (const auto& model : models) {
+            int num_vertices;
+            const auto meshes = Bench::LoadObjMeshes(model, num_vertices);
+            BenchEdgePairing(model, Subdivision::GenerateFaceConnectivity(meshes), num_vertices, iterations);
+        }
+
+        for (const int size : {100, 316, 1000, 2000}) {
+            BenchEdgePairing("grid " + std::to_string(size) + "x" + std::to_string(size),
+                             Bench::GridFaces(size, size), (size + 1) * (size + 1), iterations);
+        }
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/BenchUtil.h"
+#include "subdivision/ObjMesh.h"
+
+// Compares loading .obj files with tinyobj::LoadObj, through LoadTinyObjFromFile(), against LoadObjFile() on one
+// thread and on num_threads. Reports MB/s on the given models and on generated cubes of 100k faces up to max_faces,
+// written out as .obj files like the ones exported by modelling packages, and checks that both loaders agree.
+// Usage: obj_parse_bench [iterations] [num_threads] [max_faces] [model.obj ...]
+
+namespace {
+
+// Writes the cube as an .obj file with a normal per vertex, pointing away from the centre, and faces of v//vn.
+void WriteCubeObjFile(const std::string& obj_filename, int size) {
+    const Subdivision::TinyObjMesh cube{Bench::CubeObjMesh(size)};
+    std::FILE* file = std::fopen(obj_filename.c_str(), "w");
+    if (file == nullptr) {
+        throw std::runtime_error("Error when attempting to write " + obj_filename);
+    }
+
+    const auto& vertices = cube.attrs.vertices;
+    std::fprintf(file, "# A cube of %dx%d quads per side.\ng cube\n", size, size);
+    for (std::size_t i = 0; i < vertices.size(); i += 3) {
+        std::fprintf(file, "v %f %f %f\n", vertices[i], vertices[i + 1], vertices[i + 2]);
+    }
+    for (std::size_t i = 0; i < vertices.size(); i += 3) {
+        const float length = std::sqrt(vertices[i] * vertices[i] + vertices[i + 1] * vertices[i + 1]
+                                       + vertices[i + 2] * vertices[i + 2]);
+        std::fprintf(file, "vn %f %f %f\n", vertices[i] / length, vertices[i + 1] / length, vertices[i + 2] / length);
+    }
+
+    std::size_t offset = 0;
+    for (const int num_vertices : cube.meshes[0].num_face_vertices) {
+        std::fprintf(file, "f");
+        for (int v = 0; v < num_vertices; ++v) {
+            const int index = cube.meshes[0].indices[offset + v].vertex_index + 1;
+            std::fprintf(file, " %d//%d", index, index);
+        }
+        std::fprintf(file, "\n");
+        offset += num_vertices;
+    }
+
+    std::fclose(file);
+}
+
+long long FileSize(const std::string& filename) {
+    std::FILE* file = std::fopen(filename.c_str(), "rb");
+    if (file == nullptr) {
+        throw std::runtime_error("Error when attempting to read " + filename);
+    }
+    std::fseek(file, 0, SEEK_END);
+    const long long size = std::ftell(file);
+    std::fclose(file);
+
+    return size;
+}
+
+// The number of positions, normals and face vertices on which the loaders disagree. tinyobj splits the faces into a
+// mesh per group, and LoadObjFile() keeps them in one, so the faces are compared in file order.
+int CountDifferences(const Subdivision::TinyObjMesh& tinyobj_mesh, const Subdivision::TinyObjMesh& obj_mesh) {
+    int differences = (tinyobj_mesh.attrs.vertices != obj_mesh.attrs.vertices)
+                    + (tinyobj_mesh.attrs.normals != obj_mesh.attrs.normals);
+
+    std::vector<unsigned char> num_face_vertices;
+    std::vector<std::pair<int, int>> indices;
+    for (const auto& mesh : tinyobj_mesh.meshes) {
+        num_face_vertices.insert(num_face_vertices.end(), mesh.num_face_vertices.cbegin(),
+                                 mesh.num_face_vertices.cend());
+        for (const auto& index : mesh.indices) {
+            indices.emplace_back(index.vertex_index, index.normal_index);
+        }
+    }
+
+    const auto& mesh = obj_mesh.meshes[0];
+    differences += (num_face_vertices != mesh.num_face_vertices) + (indices.size() != mesh.indices.size());
+    for (std::size_t i = 0; i < std::min(indices.size(), mesh.indices.size()); ++i) {
+        differences += (indices[i] != std::make_pair(mesh.indices[i].vertex_index, mesh.indices[i].normal_index));
+    }
+
+    return differences;
+}
+
+void PrintThroughput(const std::string& label, const Bench::Timings& timings, long long bytes) {
+    Bench::PrintTimings(label, timings);
+    std::cout << "    " << bytes / (timings.median / 1000.0) / 1.0e6 << " MB/s (median)\n";
+}
+
+void BenchObjFile(const std::string& obj_filename, int iterations, int num_threads) {
+    const long long bytes = FileSize(obj_filename);
+    std::cout << obj_filename << ": " << bytes / 1.0e6 << " MB\n";
+
+    PrintThroughput("  LoadTinyObjFromFile", Bench::TimeIterations(iterations, [&]() {
+        Subdivision::LoadTinyObjFromFile(obj_filename);
+    }), bytes);
+    PrintThroughput("  LoadObjFile 1 thread", Bench::TimeIterations(iterations, [&]() {
+        Subdivision::LoadObjFile(obj_filename, 1);
+    }), bytes);
+    PrintThroughput("  LoadObjFile " + std::to_string(num_threads) + " threads",
+                    Bench::TimeIterations(iterations, [&]() {
+        Subdivision::LoadObjFile(obj_filename, num_threads);
+    }), bytes);
+
+    const int differences = CountDifferences(Subdivision::LoadTinyObjFromFile(obj_filename),
+                                             Subdivision::LoadObjFile(obj_filename, num_threads));
+    if (differences != 0) {
+        std::cout << "  LoadObjFile() differs from tinyobj in " << differences << " places!\n";
+    }
+}
+
+} // End anonymous namespace
+
+int main(int argc, char** argv) {
+    int iterations = 10;
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    int max_faces = 4000000;
+    std::vector<std::string> models{"../models/bigguy.obj", "../models/monsterfrog.obj"};
+
+    if (argc > 1) {
+        iterations = std::stoi(argv[1]);
+    }
+    if (argc > 2) {
+        num_threads = std::stoi(argv[2]);
+    }
+    if (argc > 3) {
+        max_faces = std::stoi(argv[3]);
+    }
+    if (argc > 4) {
+        models.assign(argv + 4, argv + argc);
+    }
+
+    std::cout << iterations << " iterations on " << num_threads << " threads\n";
+
+    try {
+        for (const auto& model : models) {
+            BenchObjFile(model, iterations, num_threads);
+        }
+
+        for (const int faces : {100000, 1000000, 4000000}) {
+            if (faces > max_faces) {
+                break;
+            }
+
+            const int cube_size = std::sqrt(faces / 6.0);
+            const std::string obj_filename = "obj_parse_bench_cube_" + std::to_string(cube_size) + ".obj";
+            WriteCubeObjFile(obj_filename, cube_size);
+            BenchObjFile(obj_filename, iterations, num_threads);
+            std::remove(obj_filename.c_str());
+        }
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench/BenchUtil.h"
+#include "subdivision/PatchKernel.h"
+#include "subdivision/Subdivision.h"
+
+// Compares ways of splitting irregular faces' 4x4 control points into the 5x5 control points of their subpatches:
+// the dense 25x16 weight table, the separable split one face at a time, and the batched kernel with and without
+// SIMD. Reports faces per second, and checks that every method agrees with the dense table.
+// Usage: patch_kernel_bench [iterations] [num_faces]
+
+namespace {
+
+struct PatchGrid {
+    std::vector<Subdivision::FaceDataPtr> face_data;
+    std::vector<Subdivision::FaceData*> faces;
+    std::vector<glm::vec3> vertex_buffer;
+};
+
+// Faces on a square grid of random points, each using the 4x4 block of points at its corner. The subpatch points
+// of each face are allocated after all the control points, as in a real refinement level.
+PatchGrid MakePatchGrid(int num_faces) {
+    const int width = std::ceil(std::sqrt(num_faces));
+    const int points_width = width + 3;
+
+    PatchGrid grid;
+    std::mt19937 rng{1234};
+    std::uniform_real_distribution<float> dist{-1.0f, 1.0f};
+    for (int i = 0; i < points_width * points_width; ++i) {
+        grid.vertex_buffer.emplace_back(dist(rng), dist(rng), dist(rng));
+    }
+
+    for (int f = 0; f < num_faces; ++f) {
+        const int x = f % width, y = f / width;
+        grid.face_data.push_back(std::make_unique<Subdivision::FaceData>(std::vector<int>{0, 0, 0, 0}, false));
+        auto& face = *grid.face_data.back();
+
+        for (int row = 0; row < 4; ++row) {
+            for (int col = 0; col < 4; ++col) {
+                face.control_points[row * 4 + col] = (y + row) * points_width + x + col;
+            }
+        }
+
+        face.first_subdivided_point = grid.vertex_buffer.size() + f * 25;
+
+        grid.faces.push_back(&face);
+    }
+
+    grid.vertex_buffer.resize(grid.vertex_buffer.size() + num_faces * 25);
+
+    return grid;
+}
+
+// The previous implementation: every subpatch point is a dot product with a row of the dense weight table.
+void SubdivideDense(const std::vector<Subdivision::FaceData*>& faces, std::vector<glm::vec3>& vertex_buffer) {
+    const auto stencil_weights{Subdivision::GetStencilWeights()};
+    for (const auto& face : faces) {
+        for (int i = 0; i < 25; ++i) {
+            glm::vec3 subdivided_vertex{};
+            for (int j = 0; j < 16; ++j) {
+                if (stencil_weights[i][j] != 0.0f) {
+                    subdivided_vertex += stencil_weights[i][j] * vertex_buffer[face->control_points[j]];
+                }
+            }
+
+            vertex_buffer[face->SubdividedPoint(i)] = subdivided_vertex;
+        }
+    }
+}
+
+void SubdivideSeparable(const std::vector<Subdivision::FaceData*>& faces, std::vector<glm::vec3>& vertex_buffer) {
+    for (const auto& face : faces) {
+        Subdivision::SubdivideControlPoints(*face, vertex_buffer);
+    }
+}
+
+// The batched kernel without SIMD, including gathering and scattering the points.
+void SubdivideBatchedScalar(const std::vector<Subdivision::FaceData*>& faces, std::vector<glm::vec3>& vertex_buffer) {
+    using Subdivision::patch_batch_size;
+
+    Subdivision::PatchBatch patches;
+    Subdivision::SubpatchBatch subpatches;
+    for (std::size_t first_face = 0; first_face < faces.size(); first_face += patch_batch_size) {
+        const int batch_faces = std::min<int>(patch_batch_size, faces.size() - first_face);
+        for (int l = 0; l < patch_batch_size; ++l) {
+            for (int i = 0; i < 16; ++i) {
+                const glm::vec3 point{(l < batch_faces) ? vertex_buffer[faces[first_face + l]->control_points[i]]
+                                                        : glm::vec3{}};
+                patches.points[i][0][l] = point.x;
+                patches.points[i][1][l] = point.y;
+                patches.points[i][2][l] = point.z;
+            }
+        }
+
+        Subdivision::SubdividePatchBatchScalar(patches, subpatches);
+
+        for (int l = 0; l < batch_faces; ++l) {
+            for (int i = 0; i < 25; ++i) {
+                vertex_buffer[faces[first_face + l]->SubdividedPoint(i)] = glm::vec3{subpatches.points[i][0][l],
+                                                                                    subpatches.points[i][1][l],
+                                                                                    subpatches.points[i][2][l]};
+            }
+        }
+    }
+}
+
+float MaxDifference(const std::vector<glm::vec3>& a, const std::vector<glm::vec3>& b) {
+    float max_difference = 0.0f;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        const glm::vec3 d{glm::abs(a[i] - b[i])};
+        max_difference = std::max({max_difference, d.x, d.y, d.z});
+    }
+
+    return max_difference;
+}
+
+void PrintThroughput(const std::string& label, const Bench::Timings& timings, int num_faces) {
+    Bench::PrintTimings(label, timings);
+    std::cout << "    " << num_faces / (timings.median / 1000.0) / 1.0e6 << " M faces/s (median)\n";
+}
+
+} // End anonymous namespace
+
+int main(int argc, char** argv) {
+    int iterations = 20;
+    int num_faces = 1 << 18;
+
+    if (argc > 1) {
+        iterations = std::stoi(argv[1]);
+    }
+    if (argc > 2) {
+        num_faces = std::stoi(argv[2]);
+    }
+
+    PatchGrid grid{MakePatchGrid(num_faces)};
+    std::cout << num_faces << " faces, batched kernel compiled for " << Subdivision::PatchKernelInstructionSet() << "\n";
+
+    auto dense_buffer = grid.vertex_buffer;
+    auto separable_buffer = grid.vertex_buffer;
+    auto scalar_buffer = grid.vertex_buffer;
+    auto simd_buffer = grid.vertex_buffer;
+
+    const auto dense_timings = Bench::TimeIterations(iterations, [&]() {
+        SubdivideDense(grid.faces, dense_buffer);
+    });
+    const auto separable_timings = Bench::TimeIterations(iterations, [&]() {
+        SubdivideSeparable(grid.faces, separable_buffer);
+    });
+    const auto scalar_timings = Bench::TimeIterations(iterations, [&]() {
+        SubdivideBatchedScalar(grid.faces, scalar_buffer);
+    });
+    const auto simd_timings = Bench::TimeIterations(iterations, [&]() {
+        Subdivision::SubdivideControlPoints(grid.faces, simd_buffer, 1);
+    });
+
+    // The kernel alone, on batches which are already in SIMD layout.
+    const int num_batches = (num_faces + Subdivision::patch_batch_size - 1) / Subdivision::patch_batch_size;
+    std::vector<Subdivision::PatchBatch> batches(num_batches);
+    std::vector<Subdivision::SubpatchBatch> subpatch_batches(num_batches);
+    for (auto& batch : batches) {
+        std::memset(&batch, 0, sizeof(batch));
+    }
+    const auto kernel_timings = Bench::TimeIterations(iterations, [&]() {
+        for (int b = 0; b < num_batches; ++b) {
+            Subdivision::SubdividePatchBatch(batches[b], subpatch_batches[b]);
+        }
+    });
+
+    PrintThroughput("dense 25x16 table", dense_timings, num_faces);
+    PrintThroughput("separable, per face", separable_timings, num_faces);
+    PrintThroughput("separable, batched scalar", scalar_timings, num_faces);
+    PrintThroughput("separable, batched " + std::string{Subdivision::PatchKernelInstructionSet()}, simd_timings,
+                    num_faces);
+    PrintThroughput("batched kernel only", kernel_timings, num_faces);
+    std::cout << "  speedup over dense table (median): " << dense_timings.median / simd_timings.median << "x\n";
+
+    std::cout << std::scientific << "max difference from dense table: separable "
+              << MaxDifference(dense_buffer, separable_buffer) << ", batched " << MaxDifference(dense_buffer, simd_buffer) << "\n";
+    if (scalar_buffer != simd_buffer || separable_buffer != simd_buffer) {
+        std::cout << "Separable results differ between scalar and SIMD!\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bench/AllocationCounter.h"
+#include "bench/BenchUtil.h"
+#include "subdivision/HalfEdge.h"
+#include "subdivision/MeshCache.h"
+#include "subdivision/ObjMesh.h"
+#include "subdivision/Plan.h"
+#include "subdivision/Subdivision.h"
+#include "subdivision/TopologyRefiner.h"
+
+// Times each stage of subdividing a mesh: loading the .obj file, the face connectivity, the half-edge edge and vertex
+// connectivity, the control points, the connectivity of the irregular region, each refinement level, the end caps and
+// the bounds of the patches, as well as compiling the subdivision plans, refining adaptively, and building a
+// TopologyRefiner and refining one or many instances with it. Runs on the given models and on generated meshes from
+// 10k faces up to max_faces, and checks that the stages add up to the same vertex buffer as SubdivideMesh().
+// For each model, also times SubdivideMeshCached() with and without its cache, and counts the heap allocations of
+// each refinement level with and without RefinementArenas.
+// Usage: subdiv_bench [iterations] [num_threads] [max_faces] [model.obj ...]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// The depth of the adaptive runs, which refine by CurvaturePriorities().
+constexpr int adaptive_depth = 4;
+
+// Run times of each stage, in the order the stages first ran.
+class StageTimes {
+public:
+    void Record(const std::string& stage, Clock::time_point start) {
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        for (auto& stage_times : times) {
+            if (stage_times.first == stage) {
+                stage_times.second.push_back(ms);
+                return;
+            }
+        }
+        times.emplace_back(stage, std::vector<double>{ms});
+    }
+
+    void Print() const {
+        for (const auto& stage_times : times) {
+            Bench::PrintTimings("  " + stage_times.first, Bench::SummarizeTimes(stage_times.second));
+        }
+    }
+
+private:
+    std::vector<std::pair<std::string, std::vector<double>>> times;
+};
+
+// The same steps as SubdivideMesh(), with each stage timed. Fills level_allocations with the number of heap
+// allocations made by each level, which allocates its connectivity from arenas unless use_arenas is false.
+std::vector<glm::vec3> RunStages(const Subdivision::TinyObjMesh& obj, int num_threads, StageTimes& stage_times,
+                                 bool use_arenas, std::vector<long long>& level_allocations) {
+    using namespace Subdivision;
+
+    RefinementArenas refinement_arenas;
+    RefinementArenas* arenas = use_arenas ? &refinement_arenas : nullptr;
+
+    std::vector<glm::vec3> vertex_buffer;
+    for (std::size_t i = 0; i < obj.attrs.vertices.size(); i += 3) {
+        vertex_buffer.emplace_back(obj.attrs.vertices[i], obj.attrs.vertices[i + 1], obj.attrs.vertices[i + 2]);
+    }
+
+    auto start = Clock::now();
+    std::vector<FaceDataPtr> face_data{GenerateFaceConnectivity(obj.meshes, num_threads)};
+    NumberPatchFaces(face_data);
+    stage_times.Record("face connectivity", start);
+
+    start = Clock::now();
+    HalfEdgeMesh mesh{GenerateHalfEdgeMesh(face_data, vertex_buffer.size(), EdgePairing::RadixSort, num_threads)};
+    GenerateHalfEdgeVertexConnectivity(mesh, face_data, num_threads);
+    stage_times.Record("edge and vertex connectivity", start);
+
+    start = Clock::now();
+    GenerateControlPoints(mesh, face_data, num_threads);
+    CompleteControlPoints(mesh, face_data, vertex_buffer);
+    stage_times.Record("control points", start);
+
+    start = Clock::now();
+    std::vector<EdgeData> edge_data{GenerateEdgeData(mesh, face_data)};
+    Arena* level_arena = use_arenas ? &arenas->NextLevel() : nullptr;
+    std::vector<VertexData> vertex_data{GenerateIrregularVertexConnectivity(edge_data, 0, vertex_buffer.size(),
+                                                                            level_arena)};
+    stage_times.Record("irregular region connectivity", start);
+
+    // Every face gets the default depth, so no region stops early.
+    const int depth = SetMaxDepths(face_data, RefinementOptions{});
+    level_allocations.clear();
+    for (int level = 1; level <= depth; ++level) {
+        const long long first_allocation = Bench::NumAllocations();
+        start = Clock::now();
+        CreateNewFaces(vertex_buffer, face_data, edge_data, vertex_data, num_threads, arenas);
+        stage_times.Record("CreateNewFaces level " + std::to_string(level), start);
+        level_allocations.push_back(Bench::NumAllocations() - first_allocation);
+    }
+
+    start = Clock::now();
+    AddEndCaps(face_data, vertex_buffer, num_threads);
+    stage_times.Record("end caps", start);
+
+    return vertex_buffer;
+}
+
+void BenchSubdivision(const std::string& name, const Subdivision::TinyObjMesh& obj, int iterations,
+                      int num_threads) {
+    int num_faces = 0;
+    for (const auto& mesh : obj.meshes) {
+        num_faces += mesh.num_face_vertices.size();
+    }
+
+    const auto subdivided = Subdivision::SubdivideMesh(obj, num_threads);
+    std::cout << name << ": " << num_faces << " faces, " << obj.attrs.vertices.size() / 3 << " vertices -> "
+              << subdivided.indices.size() / 16 << " patches, " << subdivided.vertices.size() << " points\n";
+
+    StageTimes stage_times;
+    std::vector<long long> arena_allocations;
+    for (int i = 0; i < iterations; ++i) {
+        if (RunStages(obj, num_threads, stage_times, true, arena_allocations) != subdivided.vertices) {
+            std::cout << "  The timed stages differ from SubdivideMesh()!\n";
+        }
+    }
+    stage_times.Print();
+
+    StageTimes heap_stage_times;
+    std::vector<long long> heap_allocations;
+    if (RunStages(obj, num_threads, heap_stage_times, false, heap_allocations) != subdivided.vertices) {
+        std::cout << "  The stages without arenas differ from SubdivideMesh()!\n";
+    }
+    for (std::size_t level = 0; level < heap_allocations.size(); ++level) {
+        std::cout << "  CreateNewFaces level " << level + 1 << ": " << heap_allocations[level]
+                  << " allocations from the heap, " << arena_allocations[level] << " with arenas\n";
+    }
+
+    Bench::PrintTimings("  SubdivideMesh total", Bench::TimeIterations(iterations, [&]() {
+        Subdivision::SubdivideMesh(obj, num_threads);
+    }));
+
+    // Part of SubdivideMesh(), after the stages above.
+    Bench::PrintTimings("  ComputePatchBounds", Bench::TimeIterations(iterations, [&]() {
+        Subdivision::ComputePatchBounds(subdivided.vertices, subdivided.indices, num_threads);
+    }));
+
+    // Once the topology is refined, each new set of positions only costs the weighted sums.
+    std::vector<glm::vec3> control_vertices;
+    for (std::size_t i = 0; i < obj.attrs.vertices.size(); i += 3) {
+        control_vertices.emplace_back(obj.attrs.vertices[i], obj.attrs.vertices[i + 1], obj.attrs.vertices[i + 2]);
+    }
+
+    const Subdivision::TopologyRefiner refiner{obj, num_threads};
+    Bench::PrintTimings("  TopologyRefiner", Bench::TimeIterations(iterations, [&]() {
+        Subdivision::TopologyRefiner{obj, num_threads};
+    }));
+
+    std::vector<glm::vec3> refined_vertices;
+    Bench::PrintTimings("  TopologyRefiner::Refine", Bench::TimeIterations(iterations, [&]() {
+        refiner.Refine(control_vertices, refined_vertices, num_threads);
+    }));
+
+    float max_distance = 0.0f;
+    for (std::size_t i = 0; i < refined_vertices.size(); ++i) {
+        max_distance = std::max(max_distance, glm::length(refined_vertices[i] - subdivided.vertices[i]));
+    }
+    if (refiner.Indices() != subdivided.indices || refined_vertices.size() != subdivided.vertices.size()) {
+        std::cout << "  The TopologyRefiner differs from SubdivideMesh()!\n";
+    }
+    std::cout << "    " << refiner.NumPoints() << " points, at most " << std::scientific << max_distance << std::fixed
+              << " from SubdivideMesh()\n";
+
+    // A crowd of instances of the mesh, each moved a little, refined one at a time and in SIMD batches.
+    constexpr int num_instances = 64;
+    std::vector<std::vector<glm::vec3>> instances(num_instances, control_vertices);
+    for (int n = 0; n < num_instances; ++n) {
+        for (auto& vertex : instances[n]) {
+            vertex += glm::vec3{0.01f * n, 0.0f, 0.002f * n * vertex.y};
+        }
+    }
+
+    std::vector<std::vector<glm::vec3>> refined_instances(num_instances);
+    Bench::PrintTimings("  Refine " + std::to_string(num_instances) + " instances",
+                        Bench::TimeIterations(iterations, [&]() {
+        for (int n = 0; n < num_instances; ++n) {
+            refiner.Refine(instances[n], refined_instances[n], num_threads);
+        }
+    }));
+
+    std::vector<std::vector<glm::vec3>> batched_instances;
+    Bench::PrintTimings("  RefineInstances " + std::to_string(num_instances) + " instances",
+                        Bench::TimeIterations(iterations, [&]() {
+        refiner.RefineInstances(instances, batched_instances, num_threads);
+    }));
+    if (batched_instances != refined_instances) {
+        std::cout << "  RefineInstances() differs from Refine()!\n";
+    }
+
+    // Deeper isolation everywhere, against the same depth only where the control mesh bends.
+    Subdivision::RefinementOptions options;
+    options.max_depth = adaptive_depth;
+    const auto uniform = Subdivision::SubdivideMesh(obj, num_threads, options);
+    Bench::PrintTimings("  SubdivideMesh depth " + std::to_string(adaptive_depth),
+                        Bench::TimeIterations(iterations, [&]() {
+        Subdivision::SubdivideMesh(obj, num_threads, options);
+    }));
+
+    Bench::PrintTimings("  CurvaturePriorities", Bench::TimeIterations(iterations, [&]() {
+        options.face_priorities = Subdivision::CurvaturePriorities(obj);
+    }));
+    const auto adaptive = Subdivision::SubdivideMesh(obj, num_threads, options);
+    Bench::PrintTimings("  SubdivideMesh depth " + std::to_string(adaptive_depth) + " by curvature",
+                        Bench::TimeIterations(iterations, [&]() {
+        Subdivision::SubdivideMesh(obj, num_threads, options);
+    }));
+    std::cout << "    " << uniform.indices.size() / 16 << " patches, " << uniform.vertices.size() << " points, against "
+              << adaptive.indices.size() / 16 << " patches, " << adaptive.vertices.size() << " points by curvature\n";
+
+    Subdivision::PlanTable plan_table;
+    Bench::PrintTimings("  CompileSubdivisionPlans", Bench::TimeIterations(iterations, [&]() {
+        plan_table = Subdivision::CompileSubdivisionPlans(obj, num_threads);
+    }));
+
+    std::size_t plan_weights = 0;
+    for (const auto& plan : plan_table.plans) {
+        plan_weights += plan.stencils.weights.size();
+    }
+    std::cout << "    " << plan_table.NumPatchFaces() << " patch faces share " << plan_table.plans.size()
+              << " plans, with " << plan_weights << " stencil weights\n";
+}
+
+} // End anonymous namespace
+
+int main(int argc, char** argv) {
+    int iterations = 10;
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    int max_faces = 4000000;
+    std::vector<std::string> models{"../models/bigguy.obj", "../models/monsterfrog.obj"};
+
+    if (argc > 1) {
+        iterations = std::stoi(argv[1]);
+    }
+    if (argc > 2) {
+        num_threads = std::stoi(argv[2]);
+    }
+    if (argc > 3) {
+        max_faces = std::stoi(argv[3]);
+    }
+    if (argc > 4) {
+        models.assign(argv + 4, argv + argc);
+    }
+
+    std::cout << iterations << " iterations on " << num_threads << " threads\n";
+
+    try {
+        for (const auto& model : models) {
+            Bench::PrintTimings(model + " LoadTinyObjFromFile", Bench::TimeIterations(iterations, [&]() {
+                Subdivision::LoadTinyObjFromFile(model);
+            }));
+            BenchSubdivision(model, Subdivision::LoadTinyObjFromFile(model), iterations, num_threads);
+
+            // The first call refines the mesh and writes its cache, and the rest only map it.
+            const auto cache_filename = Subdivision::MeshCacheFilename(".", Subdivision::MeshCacheKey(model, {}));
+            std::remove(cache_filename.c_str());
+            Bench::PrintTimings("  SubdivideMeshCached cold", Bench::TimeIterations(1, [&]() {
+                Subdivision::SubdivideMeshCached(model, ".", num_threads);
+            }));
+            if (!Subdivision::MappedMeshCache{cache_filename}.IsValid()) {
+                std::cout << "  The cache written by SubdivideMeshCached() can't be read back!\n";
+            }
+            Bench::PrintTimings("  SubdivideMeshCached warm", Bench::TimeIterations(iterations, [&]() {
+                Subdivision::SubdivideMeshCached(model, ".", num_threads);
+            }));
+            if (Subdivision::SubdivideMeshCached(model, ".", num_threads).vertices
+                    != Subdivision::SubdivideMesh(Subdivision::LoadTinyObjFromFile(model), num_threads).vertices) {
+                std::cout << "  The cached mesh differs from SubdivideMesh()!\n";
+            }
+            std::remove(cache_filename.c_str());
+        }
+
+        for (const int faces : {10000, 100000, 1000000, 4000000}) {
+            if (faces > max_faces) {
+                break;
+            }
+
+            // A closed mesh with a handful of extraordinary vertices, and an open one with many.
+            const int cube_size = std::sqrt(faces / 6.0);
+            BenchSubdivision("cube " + std::to_string(cube_size) + "x" + std::to_string(cube_size) + " per side",
+                             Bench::CubeObjMesh(cube_size), iterations, num_threads);
+
+            const int grid_size = std::sqrt(faces);
+            BenchSubdivision("grid " + std::to_string(grid_size) + "x" + std::to_string(grid_size)
+                             + ", triangles every 16 cells", Bench::GridObjMesh(grid_size, grid_size, 16), iterations,
+                             num_threads);
+        }
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "bench/BenchUtil.h"
+#include "subdivision/HalfEdge.h"
+#include "subdivision/ObjMesh.h"
+#include "subdivision/Subdivision.h"
+
+// Times the vertex points of the first refinement level, grouped by the valence of the vertex: walking the adjacent
+// edges and faces of each vertex as the refinement used to, through the generic kernel over the one rings gathered by
+// AllocateLevelPoints(), and through the kernel RefineControlVertex() picks for each vertex. Checks that all three
+// give the same points. Each group is refined enough times to make up about a million vertex points per iteration.
+// Usage: vertex_kernel_bench [iterations] [model.obj ...]
+
+namespace {
+
+using namespace Subdivision;
+
+constexpr int points_per_iteration = 1000000;
+
+// The first level of a mesh up to its vertex points: the connectivity of the region being refined, and a vertex
+// buffer with the face points of the level already in it.
+struct FirstLevel {
+    std::vector<FaceDataPtr> face_data;
+    std::vector<EdgeData> edge_data;
+    std::vector<VertexData> vertex_data;
+    LevelPoints level_points;
+    std::vector<glm::vec3> vertex_buffer;
+};
+
+FirstLevel BuildFirstLevel(const TinyObjMesh& obj) {
+    FirstLevel level;
+    for (std::size_t i = 0; i < obj.attrs.vertices.size(); i += 3) {
+        level.vertex_buffer.emplace_back(obj.attrs.vertices[i], obj.attrs.vertices[i + 1], obj.attrs.vertices[i + 2]);
+    }
+
+    level.face_data = GenerateFaceConnectivity(obj.meshes);
+    NumberPatchFaces(level.face_data);
+    HalfEdgeMesh mesh{GenerateHalfEdgeMesh(level.face_data, level.vertex_buffer.size(), EdgePairing::RadixSort)};
+    GenerateHalfEdgeVertexConnectivity(mesh, level.face_data);
+    GenerateControlPoints(mesh, level.face_data);
+    CompleteControlPoints(mesh, level.face_data, level.vertex_buffer);
+
+    level.edge_data = GenerateEdgeData(mesh, level.face_data);
+    level.vertex_data = GenerateIrregularVertexConnectivity(level.edge_data, 0, level.vertex_buffer.size());
+
+    level.level_points = AllocateLevelPoints(level.vertex_buffer.size(), level.face_data, level.vertex_data);
+    level.vertex_buffer.resize(level.level_points.end);
+    for (const auto& face : level.level_points.faces) {
+        InsertFaceVertex(*face, level.vertex_buffer);
+    }
+
+    return level;
+}
+
+// The vertex point of a vertex from its adjacent edges and faces, with the same arithmetic as the kernels.
+void WalkAdjacentElements(const VertexData& vertex, std::vector<glm::vec3>& vertex_buffer) {
+    glm::vec3 new_vertex;
+    if (vertex.OnBoundary()) {
+        new_vertex = vertex_buffer[vertex.boundary_vertices[0]];
+        for (std::size_t i = 1; i < vertex.boundary_vertices.size(); ++i) {
+            new_vertex += vertex_buffer[vertex.boundary_vertices[i]];
+        }
+        new_vertex += 6.0f * vertex_buffer[vertex.predecessor];
+
+        new_vertex /= 8.0f;
+    } else {
+        auto other_vertex = [&vertex](const EdgeData* edge) {
+            return (edge->vertices[0] == vertex.predecessor) ? edge->vertices[1] : edge->vertices[0];
+        };
+
+        new_vertex = vertex_buffer[other_vertex(vertex.adjacent_edges[0])];
+        for (int e = 1; e < vertex.Valence(); ++e) {
+            new_vertex += vertex_buffer[other_vertex(vertex.adjacent_edges[e])];
+        }
+
+        for (const auto& face : vertex.adjacent_faces) {
+            new_vertex += vertex_buffer[face->inserted_vertex];
+        }
+
+        float valence_f = vertex.Valence();
+        new_vertex /= valence_f * valence_f;
+        new_vertex += vertex_buffer[vertex.predecessor] * (valence_f - 2.0f) / valence_f;
+    }
+
+    vertex_buffer[vertex.inserted_vertex] = new_vertex;
+}
+
+// The indices into vertex_data of the boundary vertices, grouped under "boundary", and of the interior vertices,
+// grouped under their valence.
+std::map<std::string, std::vector<int>> GroupByValence(const std::vector<VertexData>& vertex_data) {
+    std::map<std::string, std::vector<int>> groups;
+    for (std::size_t v = 0; v < vertex_data.size(); ++v) {
+        const VertexData& vertex = vertex_data[v];
+        const std::string group = vertex.OnBoundary() ? "boundary" : "valence " + std::to_string(vertex.Valence());
+        groups[group].push_back(v);
+    }
+
+    return groups;
+}
+
+// Refines the vertices of a group repetitions times, with kernel(vertex index, vertex_buffer).
+template<typename Kernel>
+std::vector<glm::vec3> TimeGroup(const std::string& label, const FirstLevel& level, const std::vector<int>& vertices,
+                                 int iterations, Kernel kernel) {
+    const int repetitions = std::max(1, points_per_iteration / static_cast<int>(vertices.size()));
+    std::vector<glm::vec3> vertex_buffer{level.vertex_buffer};
+
+    const auto timings = Bench::TimeIterations(iterations, [&]() {
+        for (int r = 0; r < repetitions; ++r) {
+            for (const int v : vertices) {
+                kernel(v, vertex_buffer);
+            }
+        }
+    });
+
+    Bench::PrintTimings("    " + label, timings);
+    std::cout << "      " << timings.median * 1.0e6 / (static_cast<double>(repetitions) * vertices.size())
+              << " ns per vertex (median)\n";
+
+    return vertex_buffer;
+}
+
+void BenchVertexKernels(const std::string& name, const TinyObjMesh& obj, int iterations) {
+    const FirstLevel level{BuildFirstLevel(obj)};
+    std::cout << name << ": " << level.vertex_data.size() << " vertices in the refined region\n";
+
+    for (const auto& group : GroupByValence(level.vertex_data)) {
+        std::cout << "  " << group.first << ": " << group.second.size() << " vertices\n";
+
+        const auto walked = TimeGroup("adjacent elements", level, group.second, iterations,
+                                      [&level](int v, std::vector<glm::vec3>& vertex_buffer) {
+            WalkAdjacentElements(level.vertex_data[v], vertex_buffer);
+        });
+        const auto generic = TimeGroup("generic kernel", level, group.second, iterations,
+                                       [&level](int v, std::vector<glm::vec3>& vertex_buffer) {
+            RefineControlVertexGeneric(level.vertex_data[v], level.level_points.OneRing(v), vertex_buffer);
+        });
+        const auto specialized = TimeGroup("specialized kernels", level, group.second, iterations,
+                                           [&level](int v, std::vector<glm::vec3>& vertex_buffer) {
+            RefineControlVertex(level.vertex_data[v], level.level_points.OneRing(v), vertex_buffer);
+        });
+
+        if (generic != walked || specialized != walked) {
+            std::cout << "    The kernels differ from walking the adjacent edges and faces!\n";
+        }
+    }
+}
+
+} // End anonymous namespace
+
+int main(int argc, char** argv) {
+    int iterations = 10;
+    std::vector<std::string> models{"../models/bigguy.obj", "../models/monsterfrog.obj"};
+
+    if (argc > 1) {
+        iterations = std::stoi(argv[1]);
+    }
+    if (argc > 2) {
+        models.assign(argv + 2, argv + argc);
+    }
+
+    try {
+        for (const auto& model : models) {
+            BenchVertexKernels(model, LoadObjFile(model), iterations);
+        }
+
+        // The corners of the cube have valence 3, and the diagonals of the triangles in the grid give valence 5.
+        BenchVertexKernels("cube 100x100", Bench::CubeObjMesh(100), iterations);
+        BenchVertexKernels("grid 300x300", Bench::GridObjMesh(300, 300, 4), iterations);
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -29,9 +29,21 @@ int main() {
         {"shaders/light_fragment_shader.glsl", GL_FRAGMENT_SHADER}
     };
 
+    Shader::Paths plan{
+        {"shaders/plan_vertex_shader.glsl", GL_VERTEX_SHADER},
+        {"shaders/tess_control_plan.glsl", GL_TESS_CONTROL_SHADER},
+        {"shaders/tess_eval_plan.glsl", GL_TESS_EVALUATION_SHADER},
+        {"shaders/fragment_shader.glsl", GL_FRAGMENT_SHADER}
+    };
+
+    Shader::Paths plan_points{
+        {"shaders/plan_points_compute.glsl", GL_COMPUTE_SHADER}
+    };
+
     try {
         window = Renderer::InitGL(window_width, window_height);
-        std::vector<GLuint> shaders{Shader::Init(quad), Shader::Init(subd), Shader::Init(light_quad)};
+        std::vector<GLuint> shaders{Shader::Init(quad), Shader::Init(subd), Shader::Init(light_quad),
+                                    Shader::Init(plan), Shader::Init(plan_points)};
         Renderer::RenderLoop(window, shaders, window_width, window_height);
     } catch (const std::runtime_error& e) {
         std::cerr << e.what() << "\n";
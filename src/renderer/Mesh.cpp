@@ -1,20 +1,41 @@
-#include <algorithm>
+#include <cmath>
 #include <stdexcept>
-#include <iostream>
 
+#include <glm/gtc/constants.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 #include "renderer/Mesh.h"
+#include "renderer/Render.h"
 
 namespace Renderer {
 
-TinyObjMesh::TinyObjMesh(const tinyobj::attrib_t& attrib, const std::vector<tinyobj::mesh_t>& mesh)
-        : attrs(attrib)
-        , meshes(mesh) {}
+namespace {
 
-IndexedMesh::IndexedMesh(const std::vector<glm::vec3>& verts, const std::vector<int>& indexes)
-        : vertices(verts)
-        , indices(indexes) {}
+// The deepest plan tess_eval_plan.glsl can walk.
+constexpr int max_plan_depth = 8;
+
+void SetMaterialUniforms(const GLuint shader_id, const Material& mat) {
+    glUniform3f(glGetUniformLocation(shader_id, "material.ambient"), mat.ambient.r, mat.ambient.g, mat.ambient.b);
+    glUniform3f(glGetUniformLocation(shader_id, "material.diffuse"), mat.diffuse.r, mat.diffuse.g, mat.diffuse.b);
+    glUniform3f(glGetUniformLocation(shader_id, "material.specular"), mat.specular.r, mat.specular.g, mat.specular.b);
+    glUniform1f(glGetUniformLocation(shader_id, "material.shininess"), mat.shininess);
+}
+
+void SetModelUniforms(const GLuint shader_id, const glm::mat4& model, const glm::mat4& view_matrix) {
+    glUniformMatrix4fv(glGetUniformLocation(shader_id, "model"), 1, GL_FALSE, glm::value_ptr(model));
+
+    glm::mat4 model_view_inverse = glm::inverse(view_matrix * model);
+
+    GLint normal_mat_loc = glGetUniformLocation(shader_id, "normal_mat");
+    glm::mat3 normal_matrix = glm::mat3(glm::transpose(model_view_inverse));
+    glUniformMatrix3fv(normal_mat_loc, 1, GL_FALSE, glm::value_ptr(normal_matrix));
+
+    // The eye in model space, for culling patches against their bounds.
+    glm::vec3 eye_position = glm::vec3(model_view_inverse[3]);
+    glUniform3f(glGetUniformLocation(shader_id, "eye_position"), eye_position.x, eye_position.y, eye_position.z);
+}
+
+} // End anonymous namespace
 
 Material::Material(const glm::vec3& amb, const glm::vec3& diff, const glm::vec3& spec, float shine)
         : ambient(amb)
@@ -29,14 +50,15 @@ Mesh::Mesh(const std::vector<glm::vec3>& verts, const Material& material, const
         , vbo(SetUpVBO(verts))
         , vao(SetUpVAO(vbo)) {}
 
-Mesh::Mesh(const IndexedMesh& mesh, const Material& material, const GLenum type)
+Mesh::Mesh(const Subdivision::IndexedMesh& mesh, const Material& material, const GLenum type)
         : vertices(mesh.vertices)
         , indices(mesh.indices)
         , mat(material)
         , primitive_type(type)
         , vbo(SetUpVBO(vertices))
         , ebo(SetUpEBO(indices))
-        , vao(SetUpVAO(vbo, ebo)) {}
+        , vao(SetUpVAO(vbo, ebo))
+        , patch_bounds_ssbo(mesh.patch_bounds.empty() ? 0 : SetUpPatchBoundsSSBO(mesh.patch_bounds)) {}
 
 GLuint Mesh::SetUpVBO(const std::vector<glm::vec3>& vertices) {
     GLuint vbo;
@@ -97,16 +119,41 @@ GLuint Mesh::SetUpVAO(const GLuint vbo, const GLuint ebo) {
     return vao;
 }
 
+GLuint Mesh::SetUpPatchBoundsSSBO(const std::vector<Subdivision::PatchBounds>& patch_bounds) {
+    // Two vec4s per patch, as tess_control_bspline.glsl reads them: the centre and radius of a sphere around the box,
+    // and the cone axis with the sine of the cone angle. Cones too wide to ever cull get a zero axis instead.
+    std::vector<glm::vec4> packed_bounds;
+    for (const auto& bounds : patch_bounds) {
+        packed_bounds.emplace_back((bounds.box_min + bounds.box_max) * 0.5f,
+                                   glm::distance(bounds.box_min, bounds.box_max) * 0.5f);
+        if (bounds.cone_angle < glm::half_pi<float>()) {
+            packed_bounds.emplace_back(bounds.cone_axis, std::sin(bounds.cone_angle));
+        } else {
+            packed_bounds.emplace_back(0.0f, 0.0f, 0.0f, 1.0f);
+        }
+    }
+
+    GLuint ssbo = CreateSSBO(packed_bounds.size() * sizeof(glm::vec4), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, packed_bounds.size() * sizeof(glm::vec4), packed_bounds.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    return ssbo;
+}
+
 void Mesh::DrawMesh(const GLuint shader_id, const glm::mat4& view_matrix) const {
     SetMaterial(shader_id);
 
     glBindVertexArray(vao);
 
-    glUniformMatrix4fv(glGetUniformLocation(shader_id, "model"), 1, GL_FALSE, glm::value_ptr(model));
+    SetModelUniforms(shader_id, model, view_matrix);
 
-    GLint normal_mat_loc = glGetUniformLocation(shader_id, "normal_mat");
-    glm::mat3 normal_matrix = glm::mat3(glm::transpose(glm::inverse(view_matrix * model)));
-    glUniformMatrix3fv(normal_mat_loc, 1, GL_FALSE, glm::value_ptr(normal_matrix));
+    // The binding of the buffer block in tess_control_bspline.glsl.
+    if (patch_bounds_ssbo != 0) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, patch_bounds_ssbo);
+    }
+    glUniform1i(glGetUniformLocation(shader_id, "cull_back_patches"), patch_bounds_ssbo != 0 && cull_back_patches);
 
     if (ebo != 0) {
         glDrawElements(primitive_type, indices.size(), GL_UNSIGNED_INT, 0);
@@ -116,59 +163,85 @@ void Mesh::DrawMesh(const GLuint shader_id, const glm::mat4& view_matrix) const
 }
 
 void Mesh::SetMaterial(const GLuint shader_id) const {
-    glUniform3f(glGetUniformLocation(shader_id, "material.ambient"), mat.ambient.r, mat.ambient.g, mat.ambient.b);
-    glUniform3f(glGetUniformLocation(shader_id, "material.diffuse"), mat.diffuse.r, mat.diffuse.g, mat.diffuse.b);
-    glUniform3f(glGetUniformLocation(shader_id, "material.specular"), mat.specular.r, mat.specular.g, mat.specular.b);
-    glUniform1f(glGetUniformLocation(shader_id, "material.shininess"), mat.shininess);
+    SetMaterialUniforms(shader_id, mat);
 }
 
-TinyObjMesh LoadTinyObjFromFile(const std::string& obj_filename) {
-    tinyobj::attrib_t attributes;
-    std::vector<tinyobj::shape_t> shapes;
-    // I don't load materials right now, but this is still needed to call tinyobj::LoadObj.
-    std::vector<tinyobj::material_t> materials;
-
-    std::string err_msg;
-    bool success = tinyobj::LoadObj(&attributes, &shapes, &materials, &err_msg, obj_filename.c_str(), nullptr, false);
-    if (!err_msg.empty()) {
-        std::cerr << err_msg << std::endl;
-    }
-    if (!success) {
-        throw std::runtime_error("Error when attempting to load mesh from " + obj_filename);
+PlanMesh::PlanMesh(const Subdivision::TinyObjMesh& obj, const Material& material)
+        : plans(Subdivision::PackPlanTable(Subdivision::CompileSubdivisionPlans(obj)))
+        , mat(material)
+        , plan_data_ssbo(SetUpSSBO(plans.data, GL_STATIC_DRAW))
+        , plan_weights_ssbo(SetUpSSBO(plans.weights, GL_STATIC_DRAW))
+        , control_vertices_ssbo(SetUpSSBO(obj.attrs.vertices, GL_DYNAMIC_DRAW))
+        , plan_points_ssbo(CreateSSBO(plans.num_points * sizeof(glm::vec4), GL_DYNAMIC_COPY))
+        , vao(SetUpVAO()) {
+    if (plans.max_depth > max_plan_depth) {
+        throw std::runtime_error("The subdivision plans are too deep for the tessellation evaluation shader.");
     }
+}
 
-    // Haven't found any use for the name field in the shape_t struct, so I just grab the mesh_t's.
-    std::vector<tinyobj::mesh_t> meshes;
-    std::transform(shapes.cbegin(), shapes.cend(), std::back_inserter(meshes),
-                   [](const tinyobj::shape_t& shape) { return shape.mesh; });
-
-    return {attributes, meshes};
-}
-
-std::vector<glm::vec3> PolygonSoup(const TinyObjMesh& tiny_obj) {
-    std::vector<glm::vec3> mesh_data;
-
-    // Usually only one mesh in an .obj file, but iterate over them just in case.
-    for (const auto& mesh : tiny_obj.meshes) {
-        // Iterate over each face in the mesh.
-        std::size_t face_offset = 0;
-        for (const auto& valence : mesh.num_face_vertices) {
-            // Get the vertices and normals for each face from the provided indices.
-            for(std::size_t v = 0; v < valence; ++v) {
-                tinyobj::index_t idx = mesh.indices[face_offset + v];
-                mesh_data.emplace_back(tiny_obj.attrs.vertices[3 * idx.vertex_index + 0],
-                                       tiny_obj.attrs.vertices[3 * idx.vertex_index + 1],
-                                       tiny_obj.attrs.vertices[3 * idx.vertex_index + 2]);
-                mesh_data.emplace_back(tiny_obj.attrs.normals[3 * idx.normal_index + 0],
-                                       tiny_obj.attrs.normals[3 * idx.normal_index + 1],
-                                       tiny_obj.attrs.normals[3 * idx.normal_index + 2]);
-            }
-
-            face_offset += valence;
-        }
-    }
+template<typename T>
+GLuint PlanMesh::SetUpSSBO(const std::vector<T>& data, const GLenum access_type) {
+    GLuint ssbo = CreateSSBO(data.size() * sizeof(T), access_type);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, data.size() * sizeof(T), data.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    return ssbo;
+}
+
+GLuint PlanMesh::SetUpVAO() {
+    // The patches have no vertex attributes, but the core profile can't draw without a vertex array object.
+    GLuint vao;
+    glGenVertexArrays(1, &vao);
+
+    return vao;
+}
+
+void PlanMesh::UpdateControlVertices(const std::vector<float>& control_vertices) const {
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, control_vertices_ssbo);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, control_vertices.size() * sizeof(float), control_vertices.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void PlanMesh::EvaluatePoints(const GLuint compute_shader_id) const {
+    glUseProgram(compute_shader_id);
+    BindBuffers();
+
+    glUniform1i(glGetUniformLocation(compute_shader_id, "points_start"), plans.points);
+    glUniform1i(glGetUniformLocation(compute_shader_id, "stencil_offsets_start"), plans.stencil_offsets);
+    glUniform1i(glGetUniformLocation(compute_shader_id, "stencil_indices_start"), plans.stencil_indices);
+    glUniform1i(glGetUniformLocation(compute_shader_id, "rings_start"), plans.rings);
+    glUniform1i(glGetUniformLocation(compute_shader_id, "num_points"), plans.num_points);
+
+    // 64 points per work group, as in plan_points_compute.glsl.
+    glDispatchCompute((plans.num_points + 63) / 64, 1, 1);
+
+    // The tessellation evaluation shader reads the points.
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void PlanMesh::DrawMesh(const GLuint shader_id, const glm::mat4& view_matrix) const {
+    SetMaterialUniforms(shader_id, mat);
+
+    glBindVertexArray(vao);
+    BindBuffers();
+
+    SetModelUniforms(shader_id, model, view_matrix);
+    glUniform1i(glGetUniformLocation(shader_id, "nodes_start"), plans.nodes);
+    glUniform1i(glGetUniformLocation(shader_id, "faces_start"), plans.faces);
+    glUniform1i(glGetUniformLocation(shader_id, "patch_points_start"), plans.patch_points);
+
+    // One vertex per patch, so GL_PATCH_VERTICES has to be 1.
+    glDrawArrays(GL_PATCHES, 0, plans.num_patch_faces);
+}
 
-    return mesh_data;
+void PlanMesh::BindBuffers() const {
+    // The bindings of the buffer blocks in plan_points_compute.glsl and tess_eval_plan.glsl.
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, plan_data_ssbo);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, plan_weights_ssbo);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, control_vertices_ssbo);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, plan_points_ssbo);
 }
 
 } // End namespace Renderer
@@ -1,29 +1,15 @@
 #pragma once
 
 #include <vector>
-#include <string>
 
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 
-#include "externals/tiny_obj_loader.h"
+#include "subdivision/ObjMesh.h"
+#include "subdivision/Plan.h"
 
 namespace Renderer {
 
-struct TinyObjMesh {
-    tinyobj::attrib_t attrs;
-    std::vector<tinyobj::mesh_t> meshes;
-
-    TinyObjMesh(const tinyobj::attrib_t& attrib, const std::vector<tinyobj::mesh_t>& mesh);
-};
-
-struct IndexedMesh {
-    std::vector<glm::vec3> vertices;
-    std::vector<int> indices;
-
-    IndexedMesh(const std::vector<glm::vec3>& verts, const std::vector<int>& indexes);
-};
-
 struct Material {
     glm::vec3 ambient, diffuse, specular;
     float shininess;
@@ -31,20 +17,20 @@ struct Material {
     Material(const glm::vec3& amb, const glm::vec3& diff, const glm::vec3& spec, float shine);
 };
 
-TinyObjMesh LoadTinyObjFromFile(const std::string& obj_filename);
-std::vector<glm::vec3> PolygonSoup(const TinyObjMesh& tiny_obj);
-
 class Mesh {
 public:
     std::vector<glm::vec3> vertices;
     std::vector<int> indices;
     const Material& mat;
     const GLenum primitive_type;
-    const GLuint vbo, ebo = 0, vao;
+    const GLuint vbo, ebo = 0, vao, patch_bounds_ssbo = 0;
     glm::mat4 model;
+    // Whether the tessellation control shader skips patches which face away from the eye. Only meshes made of B-spline
+    // patches have the bounds this needs.
+    bool cull_back_patches = true;
 
     Mesh(const std::vector<glm::vec3>& vertices, const Material& material, const GLenum type);
-    Mesh(const IndexedMesh& mesh, const Material& material, const GLenum type);
+    Mesh(const Subdivision::IndexedMesh& mesh, const Material& material, const GLenum type);
 
     void DrawMesh(const GLuint shader_id, const glm::mat4& view_matrix) const;
 private:
@@ -54,6 +40,32 @@ private:
     static GLuint SetUpEBO(const std::vector<int>& indices);
     static GLuint SetUpVAO(const GLuint vbo);
     static GLuint SetUpVAO(const GLuint vbo, const GLuint ebo);
+    static GLuint SetUpPatchBoundsSSBO(const std::vector<Subdivision::PatchBounds>& patch_bounds);
+};
+
+// A control mesh drawn through its subdivision plans, with one patch per patch face. Only the plans and the control
+// vertices are uploaded: a compute shader evaluates the points of the plans from the control vertices, and the
+// tessellation evaluation shader evaluates the patches of the plans as it draws them.
+class PlanMesh {
+public:
+    const Subdivision::PackedPlanTable plans;
+    const Material& mat;
+    const GLuint plan_data_ssbo, plan_weights_ssbo, control_vertices_ssbo, plan_points_ssbo, vao;
+    glm::mat4 model;
+
+    PlanMesh(const Subdivision::TinyObjMesh& obj, const Material& material);
+
+    // Moves the control vertices, which must keep their number. The points have to be evaluated again afterwards.
+    void UpdateControlVertices(const std::vector<float>& control_vertices) const;
+    void EvaluatePoints(const GLuint compute_shader_id) const;
+
+    void DrawMesh(const GLuint shader_id, const glm::mat4& view_matrix) const;
+private:
+    void BindBuffers() const;
+
+    template<typename T>
+    static GLuint SetUpSSBO(const std::vector<T>& data, const GLenum access_type);
+    static GLuint SetUpVAO();
 };
 
 } // End namespace Renderer.
@@ -1,3 +1,5 @@
+#include <string>
+
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -5,18 +7,25 @@
 #include "renderer/Input.h"
 #include "renderer/Camera.h"
 #include "renderer/Mesh.h"
-#include "renderer/Subdivision.h"
+#include "subdivision/MeshCache.h"
+#include "subdivision/ObjMesh.h"
+#include "subdivision/Subdivision.h"
 
 namespace Renderer {
 
+using Subdivision::LoadObjFile;
+using Subdivision::PolygonSoup;
+using Subdivision::SubdivideMesh;
+using Subdivision::SubdivideMeshCached;
+
 void RenderLoop(GLFWwindow* window, const std::vector<GLuint>& shaders, float win_width, float win_height) {
     static_assert(sizeof(glm::vec3) == sizeof(GLfloat) * 3, "glm::vec3 is not 3 packed floats on this platform.");
 
-    auto cube_obj{LoadTinyObjFromFile("../models/cube.obj")};
-    auto quad_obj{LoadTinyObjFromFile("../models/quad.obj")};
-    auto four_obj{LoadTinyObjFromFile("../models/four_quad.obj")};
-    auto bg_obj{LoadTinyObjFromFile("../models/bigguy.obj")};
-    auto mf_obj{LoadTinyObjFromFile("../models/monsterfrog.obj")};
+    auto cube_obj{LoadObjFile("../models/cube.obj")};
+    auto quad_obj{LoadObjFile("../models/quad.obj")};
+    auto four_obj{LoadObjFile("../models/four_quad.obj")};
+    auto bg_obj{LoadObjFile("../models/bigguy.obj")};
+    auto mf_obj{LoadObjFile("../models/monsterfrog.obj")};
 
     Material cube_mat{{0.0f, 0.7f, 0.54f}, {0.0f, 0.7f, 0.54f}, {0.5f, 0.5f, 0.5f}, 64.0f};
 
@@ -31,9 +40,17 @@ void RenderLoop(GLFWwindow* window, const std::vector<GLuint>& shaders, float wi
 //    Mesh subd_cube{SubdivideMesh(cube_obj), cube_mat, GL_PATCHES};
 //    Mesh subd_quad{SubdivideMesh(quad_obj), cube_mat, GL_PATCHES};
 //    Mesh subd_four{SubdivideMesh(four_obj), cube_mat, GL_PATCHES};
-    Mesh subd_big_guy{SubdivideMesh(bg_obj), cube_mat, GL_PATCHES};
+    // Cached in the working directory, so later runs map the subdivided mesh instead of refining it again.
+    Mesh subd_big_guy{SubdivideMeshCached("../models/bigguy.obj", "."), cube_mat, GL_PATCHES};
 //    Mesh subd_monster_frog{SubdivideMesh(mf_obj), cube_mat, GL_PATCHES};
 
+    PlanMesh plan_big_guy{bg_obj, cube_mat};
+
+    // Mesa's llvmpipe restarts gl_PrimitiveID every 64 patches in the tessellation control shader, so it would cull
+    // patches by the bounds of other patches.
+    const std::string gl_renderer{reinterpret_cast<const char*>(glGetString(GL_RENDERER))};
+    subd_big_guy.cull_back_patches = gl_renderer.find("llvmpipe") == std::string::npos;
+
     Input input;
     Camera camera{{0.0f, 0.0f, 5.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, -1.0f}};
 
@@ -46,6 +63,8 @@ void RenderLoop(GLFWwindow* window, const std::vector<GLuint>& shaders, float wi
     const GLuint &quad_shader{shaders[0]};
     const GLuint &subd_shader{shaders[1]};
     const GLuint &quad_light_shader{shaders[2]};
+    const GLuint &plan_shader{shaders[3]};
+    const GLuint &plan_points_shader{shaders[4]};
 
     const bool dir_light_enabled = false, point_light_enabled = true;
 
@@ -53,6 +72,14 @@ void RenderLoop(GLFWwindow* window, const std::vector<GLuint>& shaders, float wi
     const GLuint lights_UBO = SetLightsUBO(dir_light_enabled, point_light_enabled, dir_light, point_lights);
     SetTessellationUBO();
 
+    // Flat polygons gain nothing from being tessellated, so the quads stay at one segment per edge.
+    SetTessellationFactors(quad_shader, win_width, win_height, 8.0f, 1.0f, 1.0f);
+    SetTessellationFactors(quad_light_shader, win_width, win_height, 8.0f, 1.0f, 1.0f);
+    SetTessellationFactors(subd_shader, win_width, win_height, 8.0f, 1.0f, 64.0f);
+
+    // The control vertices don't move, so the points of the plans only need to be evaluated once.
+    plan_big_guy.EvaluatePoints(plan_points_shader);
+
     //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
     while (!glfwWindowShouldClose(window)) {
@@ -88,7 +115,6 @@ void RenderLoop(GLFWwindow* window, const std::vector<GLuint>& shaders, float wi
         // Models.
         glPatchParameteri(GL_PATCH_VERTICES, 4);
         glUseProgram(quad_shader);
-        glUniform1f(glGetUniformLocation(quad_shader, "tess_level"), 1.0f);
 
 //        plain_cube.model = glm::mat4(1.0f);
 //        plain_cube.model = glm::translate(plain_cube.model, {-1.0f, -1.0f, 2.3f});
@@ -139,7 +165,6 @@ void RenderLoop(GLFWwindow* window, const std::vector<GLuint>& shaders, float wi
         if (point_light_enabled) {
             // Light cube(s).
             glUseProgram(quad_light_shader);
-            glUniform1f(glGetUniformLocation(quad_light_shader, "tess_level"), 1.0f);
 
             for (const auto& point_light : point_lights) {
                 plain_cube.model = glm::mat4(1.0f);
@@ -153,7 +178,6 @@ void RenderLoop(GLFWwindow* window, const std::vector<GLuint>& shaders, float wi
         glPatchParameteri(GL_PATCH_VERTICES, 16);
         glUseProgram(subd_shader);
 
-        glUniform1f(glGetUniformLocation(subd_shader, "tess_level"), 4.0f);
 //        subd_cube.model = glm::mat4(1.0f);
 //        subd_cube.model = glm::translate(subd_cube.model, {1.0f, -1.0f, 2.3f});
 //        subd_cube.DrawMesh(subd_shader, view);
@@ -169,36 +193,46 @@ void RenderLoop(GLFWwindow* window, const std::vector<GLuint>& shaders, float wi
 //        subd_monster_frog.model = glm::rotate(subd_monster_frog.model, glm::radians(-100.0f), {0.0f, 1.0f, 0.0f});
 //        subd_monster_frog.DrawMesh(subd_shader, view);
 
-//        glUniform1f(glGetUniformLocation(subd_shader, "tess_level"), 1.0f);
+//        glUniform2f(glGetUniformLocation(subd_shader, "tess_level_range"), 1.0f, 1.0f);
 //        quad_patch.model = glm::mat4(1.0f);
 //        quad_patch.model = glm::scale(quad_patch.model, glm::vec3(1.5f));
 //        quad_patch.model = glm::translate(quad_patch.model, {-2.0f, 0.0f, 0.0f});
 //        quad_patch.DrawMesh(subd_shader, view);
 //
-//        glUniform1f(glGetUniformLocation(subd_shader, "tess_level"), 2.0f);
+//        glUniform2f(glGetUniformLocation(subd_shader, "tess_level_range"), 2.0f, 2.0f);
 //        quad_patch.model = glm::mat4(1.0f);
 //        quad_patch.model = glm::scale(quad_patch.model, glm::vec3(1.5f));
 //        quad_patch.model = glm::translate(quad_patch.model, {-1.0f, 0.0f, 0.0f});
 //        quad_patch.DrawMesh(subd_shader, view);
 //
-//        glUniform1f(glGetUniformLocation(subd_shader, "tess_level"), 3.0f);
+//        glUniform2f(glGetUniformLocation(subd_shader, "tess_level_range"), 3.0f, 3.0f);
 //        quad_patch.model = glm::mat4(1.0f);
 //        quad_patch.model = glm::scale(quad_patch.model, glm::vec3(1.5f));
 //        quad_patch.model = glm::translate(quad_patch.model, {0.0f, 0.0f, 0.0f});
 //        quad_patch.DrawMesh(subd_shader, view);
 //
-//        glUniform1f(glGetUniformLocation(subd_shader, "tess_level"), 4.0f);
+//        glUniform2f(glGetUniformLocation(subd_shader, "tess_level_range"), 4.0f, 4.0f);
 //        quad_patch.model = glm::mat4(1.0f);
 //        quad_patch.model = glm::scale(quad_patch.model, glm::vec3(1.5f));
 //        quad_patch.model = glm::translate(quad_patch.model, {1.0f, 0.0f, 0.0f});
 //        quad_patch.DrawMesh(subd_shader, view);
 //
-//        glUniform1f(glGetUniformLocation(subd_shader, "tess_level"), 16.0f);
+//        glUniform2f(glGetUniformLocation(subd_shader, "tess_level_range"), 16.0f, 16.0f);
 //        quad_patch.model = glm::mat4(1.0f);
 //        quad_patch.model = glm::scale(quad_patch.model, glm::vec3(1.5f));
 //        quad_patch.model = glm::translate(quad_patch.model, {2.0f, 0.0f, 0.0f});
 //        quad_patch.DrawMesh(subd_shader, view);
 
+        // Subdivision plans, evaluated from the control mesh in the tessellation evaluation shader.
+        glPatchParameteri(GL_PATCH_VERTICES, 1);
+        glUseProgram(plan_shader);
+
+        glUniform1f(glGetUniformLocation(plan_shader, "tess_level"), 16.0f);
+        plan_big_guy.model = glm::mat4(1.0f);
+        plan_big_guy.model = glm::translate(plan_big_guy.model, {-14.0f, -4.0f, -8.0f});
+        plan_big_guy.model = glm::rotate(plan_big_guy.model, glm::radians(85.0f), {0.0f, 1.0f, 0.0f});
+        plan_big_guy.DrawMesh(plan_shader, view);
+
         glBindVertexArray(0);
 
         glfwSwapBuffers(window);
@@ -224,7 +258,7 @@ GLuint CreateSSBO(const std::size_t buffer_size, const GLenum access_type) {
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
     glBufferData(GL_SHADER_STORAGE_BUFFER, buffer_size, nullptr, access_type);
 
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
     return ssbo;
 }
@@ -270,6 +304,15 @@ GLuint SetTessellationUBO() {
     return tess_UBO;
 }
 
+void SetTessellationFactors(const GLuint shader_id, float win_width, float win_height, float pixels_per_edge,
+                            float min_level, float max_level) {
+    glUseProgram(shader_id);
+    glUniform2f(glGetUniformLocation(shader_id, "viewport_size"), win_width, win_height);
+    glUniform1f(glGetUniformLocation(shader_id, "pixels_per_edge"), pixels_per_edge);
+    glUniform2f(glGetUniformLocation(shader_id, "tess_level_range"), min_level, max_level);
+    glUseProgram(0);
+}
+
 GLuint SetLightsUBO(bool dir_enable, bool point_enable,
                     const DirLight& dir_light, const std::vector<PointLight>& point_lights) {
     constexpr int bind_index = 1;
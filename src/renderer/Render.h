@@ -40,6 +40,10 @@ GLuint CreateUBO(const std::size_t buffer_size, const GLenum access_type);
 GLuint CreateSSBO(const std::size_t buffer_size, const GLenum access_type); // GL_DYNAMIC_COPY
 GLuint SetMatricesUBO(float aspect);
 GLuint SetTessellationUBO();
+// For tess_control_quad.glsl and tess_control_bspline.glsl, which pick the level of each edge to give about
+// pixels_per_edge pixels per segment, within [min_level, max_level].
+void SetTessellationFactors(const GLuint shader_id, float win_width, float win_height, float pixels_per_edge,
+                            float min_level, float max_level);
 GLuint SetLightsUBO(bool dir_enable, bool point_enable,
                     const DirLight& dir_light, const std::vector<PointLight>& point_lights);
 
@@ -0,0 +1,50 @@
+#version 430 core
+
+layout (local_size_x = 64) in;
+
+// The subdivision plans, as laid out by Subdivision::PackPlanTable(). The sections of plan_data start at the offsets
+// in the uniforms below.
+layout (std430, binding = 0) readonly buffer PlanData {
+    int plan_data[];
+};
+
+layout (std430, binding = 1) readonly buffer PlanWeights {
+    float plan_weights[];
+};
+
+// Three floats per vertex, since an array of vec3 would be padded to 16 bytes per element.
+layout (std430, binding = 2) readonly buffer ControlVertices {
+    float control_vertices[];
+};
+
+layout (std430, binding = 3) writeonly buffer PlanPoints {
+    vec4 plan_points[];
+};
+
+uniform int points_start;
+uniform int stencil_offsets_start;
+uniform int stencil_indices_start;
+uniform int rings_start;
+uniform int num_points;
+
+vec3 ControlVertex(int vertex) {
+    return vec3(control_vertices[3 * vertex], control_vertices[3 * vertex + 1], control_vertices[3 * vertex + 2]);
+}
+
+// Evaluates the stencil of one point of one patch face.
+void main() {
+    int point = int(gl_GlobalInvocationID.x);
+    if (point >= num_points) {
+        return;
+    }
+
+    int ring = rings_start + plan_data[points_start + 2 * point];
+    int stencil = stencil_offsets_start + plan_data[points_start + 2 * point + 1];
+
+    vec3 position = vec3(0.0f);
+    for (int i = plan_data[stencil]; i < plan_data[stencil + 1]; ++i) {
+        position += plan_weights[i] * ControlVertex(plan_data[ring + plan_data[stencil_indices_start + i]]);
+    }
+
+    plan_points[point] = vec4(position, 1.0f);
+}
@@ -0,0 +1,7 @@
+#version 430 core
+
+// Each patch is a single vertex standing for one patch face. The tessellation evaluation shader reads everything it
+// needs from the plan buffers, so there is nothing to pass on.
+void main() {
+    gl_Position = vec4(0.0f, 0.0f, 0.0f, 1.0f);
+}
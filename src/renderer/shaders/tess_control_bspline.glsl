@@ -2,6 +2,11 @@
 
 layout (vertices = 16) out;
 
+layout (std140, binding = 0) uniform Matrices {
+    mat4 proj;
+    mat4 view;
+};
+
 in VertexData {
     vec3 position;
     vec3 normal;
@@ -12,16 +17,90 @@ out VertexData {
     vec3 normal;
 } tcs_out[];
 
-uniform float tess_level;
+// Two vec4s per patch from ComputePatchBounds(): the centre and radius of a sphere around the patch, and the axis of
+// a cone around its normals with the sine of the cone angle.
+layout (std430, binding = 0) readonly buffer PatchBounds {
+    vec4 patch_bounds[];
+};
+
+uniform mat4 model;
+uniform vec3 eye_position;
+uniform bool cull_back_patches;
+
+// The size of the viewport in pixels, the length in pixels to aim for between tessellated vertices, and the range the
+// tessellation levels are clamped to.
+uniform vec2 viewport_size;
+uniform float pixels_per_edge;
+uniform vec2 tess_level_range;
+
+vec2 ScreenPosition(int point) {
+    vec4 clip = proj * view * model * vec4(tcs_in[point].position, 1.0f);
+    return clip.xy / max(clip.w, 1e-4f) * 0.5f * viewport_size;
+}
+
+// The tessellation level of the patch edge along the given row or column of control points. The edge only depends on
+// the points it runs between, which the patch on the other side of the edge shares, in the same or the opposite order.
+// Each sum is written to give the same result in either order, so both patches get exactly the same level.
+float EdgeLevel(int p0, int p1, int p2, int p3) {
+    vec2 b0 = ScreenPosition(p0);
+    vec2 b1 = ScreenPosition(p1);
+    vec2 b2 = ScreenPosition(p2);
+    vec2 b3 = ScreenPosition(p3);
+
+    // The Bezier control polygon of the curve between the middle two points, which is at least as long as the curve.
+    vec2 e0 = ((b0 + b2) + 4.0f * b1) / 6.0f;
+    vec2 e1 = (b2 + 2.0f * b1) / 3.0f;
+    vec2 e2 = (b1 + 2.0f * b2) / 3.0f;
+    vec2 e3 = ((b1 + b3) + 4.0f * b2) / 6.0f;
+    float length = (distance(e0, e1) + distance(e2, e3)) + distance(e1, e2);
+
+    return clamp(length / pixels_per_edge, tess_level_range.x, tess_level_range.y);
+}
+
+// The patch lies inside the convex hull of its control points, so it is off screen if they all are beyond the same
+// plane of the view frustum.
+bool OutsideFrustum() {
+    vec4 clip = proj * view * model * vec4(tcs_in[0].position, 1.0f);
+    vec3 max_below = clip.xyz + clip.w;
+    vec3 max_above = clip.w - clip.xyz;
+    for (int i = 1; i < 16; ++i) {
+        clip = proj * view * model * vec4(tcs_in[i].position, 1.0f);
+        max_below = max(max_below, clip.xyz + clip.w);
+        max_above = max(max_above, clip.w - clip.xyz);
+    }
+
+    return any(lessThan(max_below, vec3(0.0f))) || any(lessThan(max_above, vec3(0.0f)));
+}
+
+// Every normal of the patch faces away from the eye if the angle between the cone axis and the direction to any point
+// of the sphere, plus the cone angle, stays under 90 degrees.
+bool FacesAway() {
+    vec4 sphere = patch_bounds[2 * gl_PrimitiveID];
+    vec4 cone = patch_bounds[2 * gl_PrimitiveID + 1];
+    vec3 to_patch = sphere.xyz - eye_position;
+    return dot(cone.xyz, to_patch) >= length(to_patch) * cone.w + sphere.w * sqrt(1.0f - cone.w * cone.w);
+}
 
 void main() {
     tcs_out[gl_InvocationID].position = tcs_in[gl_InvocationID].position;
     tcs_out[gl_InvocationID].normal = tcs_in[gl_InvocationID].normal;
 
-    gl_TessLevelOuter[0] = tess_level;
-    gl_TessLevelOuter[1] = tess_level;
-    gl_TessLevelOuter[2] = tess_level;
-    gl_TessLevelOuter[3] = tess_level;
-    gl_TessLevelInner[0] = tess_level;
-    gl_TessLevelInner[1] = tess_level;
+    if (gl_InvocationID == 0) {
+        if (OutsideFrustum() || (cull_back_patches && FacesAway())) {
+            // An outer level of 0 discards the patch before it is tessellated.
+            gl_TessLevelOuter[0] = 0.0f;
+            gl_TessLevelOuter[1] = 0.0f;
+            gl_TessLevelOuter[2] = 0.0f;
+            gl_TessLevelOuter[3] = 0.0f;
+        } else {
+            // The patch spans control points 5, 6, 10 and 9. u runs down the rows and v along the columns, and the
+            // outer levels are for the edges at u = 0, v = 0, u = 1 and v = 1.
+            gl_TessLevelOuter[0] = EdgeLevel(4, 5, 6, 7);
+            gl_TessLevelOuter[1] = EdgeLevel(1, 5, 9, 13);
+            gl_TessLevelOuter[2] = EdgeLevel(8, 9, 10, 11);
+            gl_TessLevelOuter[3] = EdgeLevel(2, 6, 10, 14);
+            gl_TessLevelInner[0] = max(gl_TessLevelOuter[1], gl_TessLevelOuter[3]);
+            gl_TessLevelInner[1] = max(gl_TessLevelOuter[0], gl_TessLevelOuter[2]);
+        }
+    }
 }
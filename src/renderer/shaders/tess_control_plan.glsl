@@ -0,0 +1,14 @@
+#version 430 core
+
+layout (vertices = 1) out;
+
+uniform float tess_level;
+
+void main() {
+    gl_TessLevelOuter[0] = tess_level;
+    gl_TessLevelOuter[1] = tess_level;
+    gl_TessLevelOuter[2] = tess_level;
+    gl_TessLevelOuter[3] = tess_level;
+    gl_TessLevelInner[0] = tess_level;
+    gl_TessLevelInner[1] = tess_level;
+}
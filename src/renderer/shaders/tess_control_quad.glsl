@@ -2,6 +2,11 @@
 
 layout (vertices = 4) out;
 
+layout (std140, binding = 0) uniform Matrices {
+    mat4 proj;
+    mat4 view;
+};
+
 in VertexData {
     vec3 position;
     vec3 normal;
@@ -12,16 +17,36 @@ out VertexData {
     vec3 normal;
 } tcs_out[];
 
-uniform float tess_level;
+uniform mat4 model;
+
+// The size of the viewport in pixels, the length in pixels to aim for between tessellated vertices, and the range the
+// tessellation levels are clamped to.
+uniform vec2 viewport_size;
+uniform float pixels_per_edge;
+uniform vec2 tess_level_range;
+
+vec2 ScreenPosition(int point) {
+    vec4 clip = proj * view * model * vec4(tcs_in[point].position, 1.0f);
+    return clip.xy / max(clip.w, 1e-4f) * 0.5f * viewport_size;
+}
+
+// The neighbouring quad shares both ends of the edge, so it gets the same level.
+float EdgeLevel(int p0, int p1) {
+    float length = distance(ScreenPosition(p0), ScreenPosition(p1));
+    return clamp(length / pixels_per_edge, tess_level_range.x, tess_level_range.y);
+}
 
 void main() {
     tcs_out[gl_InvocationID].position = tcs_in[gl_InvocationID].position;
     tcs_out[gl_InvocationID].normal = tcs_in[gl_InvocationID].normal;
 
-    gl_TessLevelOuter[0] = tess_level;
-    gl_TessLevelOuter[1] = tess_level;
-    gl_TessLevelOuter[2] = tess_level;
-    gl_TessLevelOuter[3] = tess_level;
-    gl_TessLevelInner[0] = tess_level;
-    gl_TessLevelInner[1] = tess_level;
+    if (gl_InvocationID == 0) {
+        // The outer levels are for the edges at u = 0, v = 0, u = 1 and v = 1 of tess_eval_quad.glsl.
+        gl_TessLevelOuter[0] = EdgeLevel(0, 3);
+        gl_TessLevelOuter[1] = EdgeLevel(0, 1);
+        gl_TessLevelOuter[2] = EdgeLevel(1, 2);
+        gl_TessLevelOuter[3] = EdgeLevel(3, 2);
+        gl_TessLevelInner[0] = max(gl_TessLevelOuter[1], gl_TessLevelOuter[3]);
+        gl_TessLevelInner[1] = max(gl_TessLevelOuter[0], gl_TessLevelOuter[2]);
+    }
 }
@@ -0,0 +1,103 @@
+#version 430 core
+
+layout(quads, equal_spacing, ccw) in;
+
+layout (std140, binding = 0) uniform Matrices {
+    mat4 proj;
+    mat4 view;
+};
+
+// The subdivision plans, as laid out by Subdivision::PackPlanTable(). The sections of plan_data start at the offsets
+// in the uniforms below.
+layout (std430, binding = 0) readonly buffer PlanData {
+    int plan_data[];
+};
+
+// The points of every patch face, evaluated from the control vertices by plan_points_compute.glsl.
+layout (std430, binding = 3) readonly buffer PlanPoints {
+    vec4 plan_points[];
+};
+
+uniform int nodes_start;
+uniform int faces_start;
+uniform int patch_points_start;
+
+uniform mat4 model;
+uniform mat3 normal_mat;
+
+out ShadingData {
+    vec3 frag_pos;
+    vec3 normal;
+} tes_out;
+
+// Deeper than any plan. The loops in this shader all have constant bounds, since llvmpipe runs the loops of a lone
+// tessellation coordinate only once.
+const int max_plan_depth = 8;
+
+vec4 BSplineBasis(float t) {
+    float s = 1.0f - t;
+    return vec4(s * s * s, 3.0f * t * t * t - 6.0f * t * t + 4.0f, -3.0f * t * t * t + 3.0f * t * t + 3.0f * t + 1.0f,
+                t * t * t) / 6.0f;
+}
+
+vec4 BSplineDerivative(float t) {
+    float s = 1.0f - t;
+    return vec4(-0.5f * s * s, 1.5f * t * t - 2.0f * t, -1.5f * t * t + t + 0.5f, 0.5f * t * t);
+}
+
+void main() {
+    // Each patch is one patch face, in the order of the plan table.
+    int face = faces_start + 3 * gl_PrimitiveID;
+    int rotation = plan_data[face + 1];
+    int first_point = plan_data[face + 2];
+
+    // u runs along the rows of the control points and v along the columns, as in tess_eval_bspline.glsl. Turn them
+    // into the domain of the plan, as Subdivision::RotateDomain() does.
+    float u = gl_TessCoord.x;
+    float v = gl_TessCoord.y;
+    if (rotation == 1) {
+        u = 1.0f - gl_TessCoord.y;
+        v = gl_TessCoord.x;
+    } else if (rotation == 2) {
+        u = 1.0f - gl_TessCoord.x;
+        v = 1.0f - gl_TessCoord.y;
+    } else if (rotation == 3) {
+        u = gl_TessCoord.y;
+        v = 1.0f - gl_TessCoord.x;
+    }
+
+    // Walk down the quadtree to the patch containing (u, v), moving (u, v) into the domain of each child on the way.
+    int node = plan_data[nodes_start + plan_data[face]];
+    for (int depth = 0; depth < max_plan_depth && (node & 1) == 0; ++depth) {
+        int row_offset = (u >= 0.5f) ? 1 : 0;
+        int col_offset = (v >= 0.5f) ? 1 : 0;
+        u = u * 2.0f - float(row_offset);
+        v = v * 2.0f - float(col_offset);
+
+        int quadrant = (row_offset == 0) ? col_offset : 3 - col_offset;
+        node = plan_data[nodes_start + (node >> 1) + quadrant];
+    }
+    int patch_points = patch_points_start + (node >> 1);
+
+    vec4 basis_u = BSplineBasis(u);
+    vec4 basis_v = BSplineBasis(v);
+    vec4 derivative_u = BSplineDerivative(u);
+    vec4 derivative_v = BSplineDerivative(v);
+
+    vec3 position = vec3(0.0f);
+    vec3 u_tangent = vec3(0.0f);
+    vec3 v_tangent = vec3(0.0f);
+    for (int i = 0; i < 16; ++i) {
+        vec3 point = plan_points[first_point + plan_data[patch_points + i]].xyz;
+
+        int row = i / 4;
+        int col = i % 4;
+        position += basis_u[row] * basis_v[col] * point;
+        u_tangent += derivative_u[row] * basis_v[col] * point;
+        v_tangent += basis_u[row] * derivative_v[col] * point;
+    }
+
+    gl_Position = proj * view * model * vec4(position, 1.0f);
+    tes_out.frag_pos = vec3(view * model * vec4(position, 1.0f));
+    tes_out.normal = normal_mat * normalize(cross(v_tangent, u_tangent));
+}
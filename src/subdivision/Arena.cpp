@@ -0,0 +1,47 @@
+#include <algorithm>
+#include <cstdint>
+
+#include "subdivision/Arena.h"
+
+namespace Subdivision {
+
+Arena::Arena(std::size_t first_block_size)
+        : next_block_size(first_block_size) {}
+
+void* Arena::Allocate(std::size_t size, std::size_t alignment) {
+    // Blocks kept from before a reset are reused in order, and skipped if too small for this allocation.
+    while (current_block < blocks.size()) {
+        Block& block = blocks[current_block];
+        const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(block.data.get());
+        const std::size_t aligned = (start + offset + alignment - 1) / alignment * alignment - start;
+        if (aligned + size <= block.size) {
+            offset = aligned + size;
+            return block.data.get() + aligned;
+        }
+
+        ++current_block;
+        offset = 0;
+    }
+
+    // Each new block is twice the size of the last, so the number of blocks grows with the log of the memory used.
+    const std::size_t block_size = std::max(next_block_size, size + alignment);
+    next_block_size = 2 * block_size;
+    blocks.push_back({std::unique_ptr<char[]>(new char[block_size]), block_size});
+
+    return Allocate(size, alignment);
+}
+
+void Arena::Reset() {
+    current_block = 0;
+    offset = 0;
+}
+
+Arena& RefinementArenas::NextLevel() {
+    Arena& arena = levels[next_level];
+    next_level = 1 - next_level;
+    arena.Reset();
+
+    return arena;
+}
+
+} // End namespace Subdivision
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Subdivision {
+
+// Memory handed out by bumping an offset through large blocks, and taken back all at once by Reset(). Nothing is
+// freed on its own, so objects in an arena are destroyed in place and their memory is reused after the next Reset().
+// The blocks are kept across resets, so an arena reused for similar work stops allocating after the first time.
+// Not thread-safe.
+class Arena {
+public:
+    explicit Arena(std::size_t first_block_size = 64 * 1024);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* Allocate(std::size_t size, std::size_t alignment);
+    // Makes all the memory handed out so far available again, without freeing any blocks.
+    void Reset();
+
+    // Constructs a T in the arena. Its destructor must be called by hand, if it has one which matters.
+    template<typename T, typename... Args>
+    T* New(Args&&... args) {
+        return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // The number of blocks taken from the heap.
+    int NumBlocks() const { return blocks.size(); }
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        std::size_t size;
+    };
+
+    std::vector<Block> blocks;
+    std::size_t next_block_size;
+    std::size_t current_block = 0;
+    std::size_t offset = 0;
+};
+
+// An allocator for the standard containers which takes its memory from an arena, or from the heap if it has none.
+// Deallocating from an arena does nothing; the memory comes back with the arena's Reset().
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator() noexcept = default;
+    ArenaAllocator(Arena* source) noexcept : arena(source) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.GetArena()) {}
+
+    T* allocate(std::size_t n) {
+        if (arena == nullptr) {
+            return std::allocator<T>{}.allocate(n);
+        }
+        return static_cast<T*>(arena->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        if (arena == nullptr) {
+            std::allocator<T>{}.deallocate(p, n);
+        }
+    }
+
+    Arena* GetArena() const noexcept { return arena; }
+
+private:
+    Arena* arena = nullptr;
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept {
+    return lhs.GetArena() == rhs.GetArena();
+}
+
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// The arenas of one refinement. The faces each level creates live until the refinement is done, so they share one
+// arena, which must outlive the faces. The edges and vertices of a level are only read by the level after it, so two
+// arenas take turns holding them: each is reset when its turn comes round again, once the level before last is gone.
+struct RefinementArenas {
+    Arena faces;
+    std::array<Arena, 2> levels;
+    int next_level = 0;
+
+    // The arena for the connectivity of the next level, emptied of the level before last.
+    Arena& NextLevel();
+};
+
+} // End namespace Subdivision
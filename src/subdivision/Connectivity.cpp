@@ -0,0 +1,204 @@
+#include <stdexcept>
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+#include "subdivision/Connectivity.h"
+#include "subdivision/Parallel.h"
+
+namespace Subdivision {
+
+namespace {
+
+// Entries of the vertex index arrays of GenerateIrregularVertexConnectivity() for vertices without a record yet.
+constexpr int regular_vertex = -1;
+constexpr int unnumbered_vertex = -2;
+
+// Adds edge to the records of its vertices which have one, creating the record the first time a vertex is found.
+void FindEdgeVertices(ArenaVector<int>& vertex_indices, int first_vertex, std::vector<VertexData>& vertices,
+                      EdgeData& edge, Arena* arena) {
+    auto add_face = [](VertexData& vertex, FaceData* face) {
+        const auto& faces = vertex.adjacent_faces;
+        if (std::find(faces.cbegin(), faces.cend(), face) == faces.cend()) {
+            vertex.adjacent_faces.push_back(face);
+        }
+    };
+
+    // Insert the neighbouring vertices of each vertex from this edge.
+    for (int end = 0; end < 2; ++end) {
+        int& index = vertex_indices[edge.vertices[end] - first_vertex];
+        if (index == regular_vertex) {
+            continue;
+        }
+        if (index == unnumbered_vertex) {
+            index = vertices.size();
+            vertices.emplace_back(edge.vertices[end], 0.0f, arena);
+            vertices.back().adjacent_irregular = true;
+        }
+
+        VertexData& vertex = vertices[index];
+        vertex.adjacent_edges.push_back(&edge);
+        add_face(vertex, edge.adjacent_faces[0]);
+        if (edge.OnBoundary()) {
+            vertex.boundary_vertices.push_back(edge.vertices[1 - end]);
+        } else {
+            add_face(vertex, edge.adjacent_faces[1]);
+        }
+    }
+}
+
+} // End anonymous namespace
+
+EdgeKey::EdgeKey(int v1, int v2) noexcept {
+    // vertex1 always contains the smaller index.
+    if (v1 < v2) {
+        vertex1 = v1;
+        vertex2 = v2;
+    } else {
+        vertex2 = v1;
+        vertex1 = v2;
+    }
+}
+
+FaceData::FaceData(const std::vector<int>& vertex_indices, bool reg)
+        : vertices(vertex_indices.cbegin(), vertex_indices.cend())
+        , regular(reg) {}
+
+FaceData::FaceData(ArenaVector<int> vertex_indices, bool reg)
+        : vertices(std::move(vertex_indices))
+        , regular(reg) {}
+
+void FaceDataDeleter::operator()(FaceData* face) const {
+    if (in_arena) {
+        face->~FaceData();
+    } else {
+        delete face;
+    }
+}
+
+FaceDataPtr MakeFaceData(Arena* arena, ArenaVector<int> vertex_indices, bool reg) {
+    if (arena == nullptr) {
+        return FaceDataPtr{new FaceData(std::move(vertex_indices), reg)};
+    }
+
+    return FaceDataPtr{arena->New<FaceData>(std::move(vertex_indices), reg), FaceDataDeleter{true}};
+}
+
+EdgeData::EdgeData(int vertex1, int vertex2, FaceData* face1, FaceData* face2, int ffv, float sharp) noexcept
+        : vertices({{vertex1, vertex2}})
+        , adjacent_faces({{face1, face2}})
+        , first_face_vertex(ffv)
+        , sharpness(sharp) {}
+
+VertexData::VertexData(int pred, float sharp, Arena* arena) noexcept
+        : adjacent_edges(arena)
+        , adjacent_faces(arena)
+        , boundary_vertices(arena)
+        , predecessor(pred)
+        , sharpness(sharp) {}
+
+std::vector<FaceDataPtr> GenerateFaceConnectivity(const std::vector<tinyobj::mesh_t>& meshes, int num_threads) {
+    std::vector<FaceDataPtr> face_data;
+
+    // Get the face-vertex data from the provided .obj.
+    // Usually only one mesh in an .obj file, but iterate over them just in case.
+    for (const auto& mesh : meshes) {
+        // Find where each face starts in the index list first, so the faces can be built independently.
+        const int num_faces = mesh.num_face_vertices.size();
+        std::vector<int> face_offsets(num_faces + 1, 0);
+        for (int f = 0; f < num_faces; ++f) {
+            face_offsets[f + 1] = face_offsets[f] + mesh.num_face_vertices[f];
+        }
+
+        const int first_face = face_data.size();
+        face_data.resize(first_face + num_faces);
+
+        ParallelFor(0, num_faces, num_threads, [&](int faces_begin, int faces_end) {
+            for (int f = faces_begin; f < faces_end; ++f) {
+                std::vector<int> face_indices;
+                for (int i = face_offsets[f]; i < face_offsets[f + 1]; ++i) {
+                    face_indices.push_back(mesh.indices[i].vertex_index);
+                }
+
+                // We assume the face vertices come from the .obj file in counterclockwise order. Subdivided faces
+                // inherit this winding from their parent, so no geometry is needed to orient them later.
+                const bool regular = face_indices.size() == 4;
+                face_data[first_face + f] = std::make_unique<FaceData>(face_indices, regular);
+            }
+        });
+    }
+
+    return face_data;
+}
+
+void FindFaceEdges(EdgeIndexMap& edge_indices, std::vector<EdgeData>& edges, FaceData* face) {
+    // Loop over each edge of the face.
+    for (int v = 0; v < face->Valence(); ++v) {
+        int first_index = face->vertices[v];
+        int second_index = face->vertices[(v + 1) % face->Valence()];
+
+        EdgeKey edge{first_index, second_index};
+        auto map_insert = edge_indices.emplace(edge, edges.size());
+
+        // Check if we have already found this edge.
+        if (map_insert.second) {
+            edges.emplace_back(edge.vertex1, edge.vertex2, face, nullptr, v, 0.0f);
+        } else {
+            EdgeData& found_edge = edges[map_insert.first->second];
+            if (found_edge.adjacent_faces[1] == nullptr) {
+                // Edge has already been found once. Add a pointer to the second face.
+                found_edge.adjacent_faces[1] = face;
+            } else {
+                // Edge found a third time - we do not handle meshes with edges adjacent to more than 2 faces.
+                throw std::runtime_error("Edge with valence > 2 found in mesh.");
+            }
+        }
+    }
+}
+
+std::vector<VertexData> GenerateIrregularVertexConnectivity(std::vector<EdgeData>& edge_data, int first_vertex,
+                                                            int end_vertex, Arena* arena) {
+    // Only vertices adjacent to an irregular face which is still being refined get a record, and those are the
+    // vertices of the edges of such faces. Mark them first, so the records can be built in one pass over the edges.
+    ArenaVector<int> vertex_indices(end_vertex - first_vertex, regular_vertex, arena);
+    int num_irregular = 0;
+    for (const auto& edge : edge_data) {
+        if (edge.adjacent_faces[0]->Refines() || (!edge.OnBoundary() && edge.adjacent_faces[1]->Refines())) {
+            for (const int vertex : edge.vertices) {
+                int& index = vertex_indices[vertex - first_vertex];
+                if (index == regular_vertex) {
+                    index = unnumbered_vertex;
+                    ++num_irregular;
+                }
+            }
+        }
+    }
+
+    std::vector<VertexData> vertex_data;
+    vertex_data.reserve(num_irregular);
+    for (auto& edge : edge_data) {
+        FindEdgeVertices(vertex_indices, first_vertex, vertex_data, edge, arena);
+    }
+
+    for (const auto& vertex : vertex_data) {
+        if (vertex.boundary_vertices.size() > 2) {
+            throw std::runtime_error("Found a vertex with " + std::to_string(vertex.boundary_vertices.size()) +
+                                    " boundary edges. Non-manifold surfaces are not supported.");
+        }
+    }
+
+    return vertex_data;
+}
+
+int IndexOfVertexInFace(const FaceData* face, const int vertex_index) {
+    for (int i = 0; i < face->Valence(); ++i) {
+        if (face->vertices[i] == vertex_index) {
+            return i;
+        }
+    }
+
+    // Will not happen if the face is from vertex.adjacent_faces.
+    return -1;
+}
+
+} // End namespace Subdivision
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include <array>
+#include <memory>
+#include <functional>
+#include <utility>
+
+#include <glm/glm.hpp>
+
+#include "externals/tiny_obj_loader.h"
+#include "subdivision/Arena.h"
+
+namespace Subdivision {
+
+struct EdgeKey {
+    int vertex1, vertex2;
+
+    EdgeKey(int v1, int v2) noexcept;
+};
+
+constexpr bool operator==(const EdgeKey& lhs, const EdgeKey& rhs) noexcept {
+    return (lhs.vertex1 == rhs.vertex1 && lhs.vertex2 == rhs.vertex2);
+}
+
+constexpr bool operator!=(const EdgeKey& lhs, const EdgeKey& rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+} // End namespace Subdivision
+
+// Specialization of std::hash for EdgeKey.
+namespace std {
+
+template<>
+struct hash<Subdivision::EdgeKey> {
+    typedef Subdivision::EdgeKey argument_type;
+    typedef std::size_t result_type;
+    result_type operator()(const argument_type& e) const noexcept {
+        const result_type r1{std::hash<int>{}(e.vertex1)};
+        const result_type r2{std::hash<int>{}(e.vertex2)};
+        return r1 ^ (r2 << 1);
+    }
+};
+
+} // End namespace std
+
+namespace Subdivision {
+
+struct FaceData {
+    const ArenaVector<int> vertices;
+
+    std::array<int, 4> vertex_valences;
+    // Whether the one ring of each corner is a regular grid, which the local connectivity of later levels can't tell.
+    std::array<bool, 4> regular_corners{};
+    std::array<int, 16> control_points{};
+    // The 5x5 control points of the subpatches split from control_points follow each other in the vertex buffer from
+    // here, while this face is being split.
+    int first_subdivided_point = -1;
+
+    bool regular;
+    int inserted_vertex = -1;
+
+    // The corner of the control point grid at vertices[0]. Faces split from a quad keep the orientation of its grid,
+    // so the grids of later faces are rotated against their vertices.
+    int grid_rotation = 0;
+    // The patch face this face was split from, and the square of its domain this face covers, out of a grid of
+    // 2^depth by 2^depth squares. Rows run from vertices[0] to vertices[3] of the patch face, and columns from
+    // vertices[0] to vertices[1]. Polygons other than quads hold the first of their patch faces, one per corner.
+    int patch_face = -1;
+    int depth = 0;
+    int domain_row = 0;
+    int domain_col = 0;
+
+    // The number of levels the irregular region around this face is refined to, inherited from its face of the control
+    // mesh. Irregular faces whose region stops before the last level are marked as end caps and left alone.
+    int max_depth = 0;
+    bool end_cap = false;
+
+    FaceData(const std::vector<int>& vertex_indices, bool reg);
+    FaceData(ArenaVector<int> vertex_indices, bool reg);
+
+    int Valence() const { return vertices.size(); }
+    // Whether the next level of refinement splits this face.
+    bool Refines() const { return !regular && !end_cap; }
+    // Only quads have control points, and so do the faces split from them. Faces split from other polygons get
+    // theirs when they become end caps.
+    bool HasControlPoints() const { return control_points[5] != -1; }
+    int SubdividedPoint(int i) const { return first_subdivided_point + i; }
+};
+
+// Faces created by the refinement live in its RefinementArenas, so their pointers only destroy them in place.
+struct FaceDataDeleter {
+    bool in_arena = false;
+
+    FaceDataDeleter() noexcept = default;
+    FaceDataDeleter(std::default_delete<FaceData>) noexcept {}
+    explicit FaceDataDeleter(bool arena) noexcept : in_arena(arena) {}
+
+    void operator()(FaceData* face) const;
+};
+
+using FaceDataPtr = std::unique_ptr<FaceData, FaceDataDeleter>;
+
+// A face allocated from arena, or from the heap if there is none.
+FaceDataPtr MakeFaceData(Arena* arena, ArenaVector<int> vertex_indices, bool reg);
+
+struct EdgeData {
+    const std::array<int, 2> vertices;
+    std::array<FaceData*, 2> adjacent_faces;
+
+    const int first_face_vertex;
+
+    const float sharpness;
+    int inserted_vertex = -1;
+
+    EdgeData(int vertex1, int vertex2, FaceData* face1, FaceData* face2, int ffv, float sharp) noexcept;
+
+    bool OnBoundary() const { return adjacent_faces[1] == nullptr; }
+};
+
+struct VertexData {
+    ArenaVector<EdgeData*> adjacent_edges;
+    // Each adjacent face once, in the order they are first reached through adjacent_edges.
+    ArenaVector<FaceData*> adjacent_faces;
+    ArenaVector<int> boundary_vertices;
+
+    const int predecessor;
+    const float sharpness;
+    bool adjacent_irregular = false;
+    int inserted_vertex = -1;
+
+    VertexData(int pred, float sharp, Arena* arena = nullptr) noexcept;
+
+    bool OnBoundary() const { return !boundary_vertices.empty(); }
+    int Valence() const { return adjacent_edges.size(); }
+    int FaceValence() const { return adjacent_faces.size(); }
+};
+
+std::vector<FaceDataPtr> GenerateFaceConnectivity(const std::vector<tinyobj::mesh_t>& meshes, int num_threads = 1);
+
+// Edges and vertices are stored in the order they are first found, so connectivity built from the same faces is
+// always laid out the same way. The maps only hold indices into the vectors.
+using EdgeIndexMap = std::unordered_map<EdgeKey, int, std::hash<EdgeKey>, std::equal_to<EdgeKey>,
+                                        ArenaAllocator<std::pair<const EdgeKey, int>>>;
+void FindFaceEdges(EdgeIndexMap& edge_indices, std::vector<EdgeData>& edges, FaceData* face);
+
+// The vertices around the faces still being refined, in the order they are first found in edge_data. The edges must
+// only reach vertices from first_vertex up to end_vertex, which index a flat array instead of a map, so the work is
+// proportional to the edges and the range rather than to hash lookups. The lists of adjacent edges and faces of each
+// vertex are allocated from arena, if given, which must then outlive them.
+std::vector<VertexData> GenerateIrregularVertexConnectivity(std::vector<EdgeData>& edge_data, int first_vertex,
+                                                            int end_vertex, Arena* arena = nullptr);
+
+int IndexOfVertexInFace(const FaceData* face, const int vertex_index);
+
+} // End namespace Subdivision
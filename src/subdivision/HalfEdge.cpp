@@ -0,0 +1,418 @@
+#include <stdexcept>
+#include <algorithm>
+#include <string>
+#include <cassert>
+
+#include "subdivision/HalfEdge.h"
+#include "subdivision/Parallel.h"
+
+namespace Subdivision {
+
+HalfEdgeMesh GenerateHalfEdgeMesh(const std::vector<FaceDataPtr>& face_data, int num_vertices,
+                                  EdgePairing pairing, int num_threads) {
+    HalfEdgeMesh mesh;
+
+    // Lay out the half-edges of each face contiguously, in the order of the face's vertices.
+    mesh.face_begin.reserve(face_data.size() + 1);
+    mesh.face_begin.push_back(0);
+    for (const auto& face : face_data) {
+        mesh.face_begin.push_back(mesh.face_begin.back() + face->Valence());
+    }
+
+    const int num_half_edges = mesh.face_begin.back();
+    mesh.twin.assign(num_half_edges, -1);
+    mesh.next.resize(num_half_edges);
+    mesh.vertex.resize(num_half_edges);
+    mesh.face.resize(num_half_edges);
+
+    ParallelFor(0, mesh.NumFaces(), num_threads, [&mesh, &face_data](int faces_begin, int faces_end) {
+        for (int f = faces_begin; f < faces_end; ++f) {
+            const int valence = face_data[f]->Valence();
+            for (int v = 0; v < valence; ++v) {
+                const int h = mesh.face_begin[f] + v;
+                mesh.vertex[h] = face_data[f]->vertices[v];
+                mesh.next[h] = mesh.face_begin[f] + (v + 1) % valence;
+                mesh.face[h] = f;
+            }
+        }
+    });
+
+    if (pairing == EdgePairing::HashMap) {
+        PairHalfEdgesHashMap(mesh);
+    } else {
+        PairHalfEdgesRadixSort(mesh, num_threads);
+    }
+
+    mesh.vertex_edge.assign(num_vertices, -1);
+    mesh.vertex_valence.assign(num_vertices, 0);
+    mesh.vertex_boundary_edges.assign(num_vertices, 0);
+
+    return mesh;
+}
+
+void PairHalfEdgesHashMap(HalfEdgeMesh& mesh) {
+    // Pair up the two half-edges of each edge. We keep track of the first half-edge found for each edge in a map,
+    // and link it to the second one when that is found.
+    std::unordered_map<EdgeKey, std::int32_t> edges;
+    for (int h = 0; h < mesh.NumHalfEdges(); ++h) {
+        auto map_insert = edges.emplace(EdgeKey{mesh.vertex[h], mesh.vertex[mesh.next[h]]}, h);
+
+        if (!map_insert.second) {
+            const int other = map_insert.first->second;
+            if (mesh.twin[other] != -1) {
+                // Edge found a third time - we do not handle meshes with edges adjacent to more than 2 faces.
+                throw std::runtime_error("Edge with valence > 2 found in mesh.");
+            }
+
+            mesh.twin[other] = h;
+            mesh.twin[h] = other;
+        }
+    }
+}
+
+void PairHalfEdgesRadixSort(HalfEdgeMesh& mesh, int num_threads) {
+    const int num_half_edges = mesh.NumHalfEdges();
+    const int vertex_bits = VertexBits(mesh, num_threads);
+
+    // Pack the (min, max) vertex pair of each edge into a 64-bit key, using only as many bits per vertex as the
+    // largest index needs. This keeps the number of sorting passes down on smaller meshes.
+    std::vector<std::uint64_t> keys(num_half_edges);
+    std::vector<std::int32_t> half_edges(num_half_edges);
+    ParallelFor(0, num_half_edges, num_threads, [&](int edges_begin, int edges_end) {
+        for (int h = edges_begin; h < edges_end; ++h) {
+            EdgeKey edge{mesh.vertex[h], mesh.vertex[mesh.next[h]]};
+            keys[h] = (static_cast<std::uint64_t>(edge.vertex1) << vertex_bits)
+                      | static_cast<std::uint64_t>(edge.vertex2);
+            half_edges[h] = h;
+        }
+    });
+
+    // The sort is stable, so the half-edges of an edge stay in index order.
+    RadixSort(keys, half_edges, 2 * vertex_bits, num_threads);
+
+    // The half-edges of each edge are now neighbours. Each chunk pairs the edges whose run of keys starts inside it.
+    ParallelFor(0, num_half_edges, num_threads, [&](int edges_begin, int edges_end) {
+        int i = edges_begin;
+        while (i > 0 && i < num_half_edges && keys[i] == keys[i - 1]) {
+            ++i;
+        }
+
+        while (i < edges_end) {
+            int run_end = i + 1;
+            while (run_end < num_half_edges && keys[run_end] == keys[i]) {
+                ++run_end;
+            }
+
+            if (run_end - i > 2) {
+                // We do not handle meshes with edges adjacent to more than 2 faces.
+                throw std::runtime_error("Edge with valence > 2 found in mesh.");
+            } else if (run_end - i == 2) {
+                mesh.twin[half_edges[i]] = half_edges[i + 1];
+                mesh.twin[half_edges[i + 1]] = half_edges[i];
+            }
+
+            i = run_end;
+        }
+    });
+}
+
+void GenerateHalfEdgeVertexConnectivity(HalfEdgeMesh& mesh, std::vector<FaceDataPtr>& face_data, int num_threads) {
+    GenerateVertexValences(mesh, num_threads);
+
+    ParallelFor(0, mesh.NumVertices(), num_threads, [&mesh](int vertices_begin, int vertices_end) {
+        for (int v = vertices_begin; v < vertices_end; ++v) {
+            if (mesh.vertex_boundary_edges[v] > 2) {
+                throw std::runtime_error("Found a vertex with " + std::to_string(mesh.vertex_boundary_edges[v]) +
+                                         " boundary edges. Non-manifold surfaces are not supported.");
+            }
+        }
+    });
+
+    ParallelFor(0, mesh.NumFaces(), num_threads, [&mesh, &face_data](int faces_begin, int faces_end) {
+        for (int f = faces_begin; f < faces_end; ++f) {
+            FaceData& face = *face_data[f];
+            for (int i = 0; i < mesh.FaceSize(f); ++i) {
+                const int v = mesh.vertex[mesh.face_begin[f] + i];
+
+                // If this is an extraordinary vertex, the face is irregular.
+                const bool regular_vertex = RegularVertex(mesh, v);
+                if (!regular_vertex) {
+                    face.regular = false;
+                }
+
+                if (i < static_cast<int>(face.vertex_valences.size())) {
+                    face.vertex_valences[i] = mesh.vertex_valence[v];
+                    face.regular_corners[i] = regular_vertex;
+                }
+            }
+        }
+    });
+}
+
+void GenerateVertexValences(HalfEdgeMesh& mesh, int num_threads) {
+    if (ChunkCount(mesh.NumHalfEdges(), num_threads) == 1) {
+        CountVertexEdges(mesh);
+    } else {
+        CountVertexEdgesSorted(mesh, num_threads);
+    }
+}
+
+void CountVertexEdges(HalfEdgeMesh& mesh) {
+    // Interior edges are counted once at the vertex their half-edge leaves from, and once more at the other end by
+    // the twin. Boundary edges only have one half-edge, so they are counted at both ends.
+    for (int h = 0; h < mesh.NumHalfEdges(); ++h) {
+        const int v = mesh.vertex[h];
+        ++mesh.vertex_valence[v];
+
+        if (mesh.vertex_edge[v] == -1) {
+            mesh.vertex_edge[v] = h;
+        }
+
+        if (mesh.twin[h] == -1) {
+            const int other = mesh.vertex[mesh.next[h]];
+            ++mesh.vertex_valence[other];
+            ++mesh.vertex_boundary_edges[v];
+            ++mesh.vertex_boundary_edges[other];
+
+            // Start walks around boundary vertices from the boundary, so they don't stop early.
+            mesh.vertex_edge[v] = h;
+        }
+    }
+}
+
+void CountVertexEdgesSorted(HalfEdgeMesh& mesh, int num_threads) {
+    const int num_half_edges = mesh.NumHalfEdges();
+
+    // Group the outgoing half-edges of each vertex together, so that every vertex can be counted by one thread
+    // without touching any other vertex. The sort is stable, so each group stays in index order.
+    std::vector<std::uint64_t> keys(num_half_edges);
+    std::vector<std::int32_t> outgoing(num_half_edges);
+    ParallelFor(0, num_half_edges, num_threads, [&](int edges_begin, int edges_end) {
+        for (int h = edges_begin; h < edges_end; ++h) {
+            keys[h] = mesh.vertex[h];
+            outgoing[h] = h;
+        }
+    });
+
+    RadixSort(keys, outgoing, VertexBits(mesh, num_threads), num_threads);
+
+    ParallelFor(0, num_half_edges, num_threads, [&](int edges_begin, int edges_end) {
+        for (int i = edges_begin; i < edges_end; ++i) {
+            if (i == 0 || keys[i] != keys[i - 1]) {
+                mesh.vertex_edge[keys[i]] = i;
+            }
+        }
+    });
+
+    // Every half-edge arriving at a vertex is followed by one leaving it in the same face, so the boundary edges
+    // ending at v are exactly the boundary half-edges before v's outgoing half-edges. This counts the same edges as
+    // CountVertexEdges(), and picks the same vertex_edge.
+    ParallelFor(0, mesh.NumVertices(), num_threads, [&](int vertices_begin, int vertices_end) {
+        for (int v = vertices_begin; v < vertices_end; ++v) {
+            if (mesh.vertex_edge[v] == -1) {
+                continue;
+            }
+
+            int valence = 0, boundary_edges = 0;
+            int vertex_edge = outgoing[mesh.vertex_edge[v]];
+            for (int i = mesh.vertex_edge[v]; i < num_half_edges && keys[i] == static_cast<std::uint64_t>(v); ++i) {
+                const int h = outgoing[i];
+                ++valence;
+
+                if (mesh.twin[h] == -1) {
+                    ++boundary_edges;
+                    vertex_edge = h;
+                }
+
+                if (mesh.twin[mesh.Prev(h)] == -1) {
+                    ++valence;
+                    ++boundary_edges;
+                }
+            }
+
+            mesh.vertex_valence[v] = valence;
+            mesh.vertex_boundary_edges[v] = boundary_edges;
+            mesh.vertex_edge[v] = vertex_edge;
+        }
+    });
+}
+
+int VertexBits(const HalfEdgeMesh& mesh, int num_threads) {
+    std::vector<int> chunk_max(ChunkCount(mesh.NumHalfEdges(), num_threads), 0);
+    ParallelChunks(chunk_max.size(), [&mesh, &chunk_max](int chunk) {
+        const int num_chunks = chunk_max.size();
+        const int edges_begin = ChunkBegin(0, mesh.NumHalfEdges(), num_chunks, chunk);
+        const int edges_end = ChunkBegin(0, mesh.NumHalfEdges(), num_chunks, chunk + 1);
+        for (int h = edges_begin; h < edges_end; ++h) {
+            chunk_max[chunk] = std::max(chunk_max[chunk], static_cast<int>(mesh.vertex[h]));
+        }
+    });
+
+    const int max_vertex = *std::max_element(chunk_max.cbegin(), chunk_max.cend());
+    int vertex_bits = 1;
+    while ((std::int64_t{1} << vertex_bits) <= max_vertex) {
+        ++vertex_bits;
+    }
+
+    return vertex_bits;
+}
+
+bool RegularVertex(const HalfEdgeMesh& mesh, int v) {
+    // Interior vertices need four faces. The one ring of a boundary vertex with one or two faces can be completed with
+    // phantom points, extrapolated across the boundary.
+    const int valence = mesh.vertex_valence[v];
+    if (mesh.OnBoundary(v) ? (valence > 3) : (valence != 4)) {
+        return false;
+    }
+
+    // Every face around the vertex must be a quad as well.
+    const int first = mesh.vertex_edge[v];
+    int h = first;
+    do {
+        if (mesh.FaceSize(mesh.face[h]) != 4) {
+            return false;
+        }
+        h = mesh.NextAroundVertex(h);
+    } while (h != -1 && h != first);
+
+    return true;
+}
+
+std::vector<EdgeData> GenerateEdgeData(const HalfEdgeMesh& mesh, std::vector<FaceDataPtr>& face_data) {
+    // Each edge is stored once, from its first half-edge.
+    std::vector<EdgeData> edge_data;
+    for (int h = 0; h < mesh.NumHalfEdges(); ++h) {
+        const int t = mesh.twin[h];
+        if (t != -1 && t < h) {
+            continue;
+        }
+
+        EdgeKey edge{mesh.vertex[h], mesh.vertex[mesh.next[h]]};
+        FaceData* other_face = (t == -1) ? nullptr : face_data[mesh.face[t]].get();
+        edge_data.emplace_back(edge.vertex1, edge.vertex2, face_data[mesh.face[h]].get(), other_face,
+                               h - mesh.face_begin[mesh.face[h]], 0.0f);
+    }
+
+    return edge_data;
+}
+
+std::array<int, 8> FaceOneRing(const HalfEdgeMesh& mesh, int face) {
+    // The one ring holds the four faces across the edges of this face at odd indices, and the four faces diagonally
+    // across its corners at even indices, starting from the corner at the face's first vertex. Each ring face is
+    // stored as the half-edge which lines up with the first half-edge of this face, as if the ring face were moved
+    // on top of this face. The ring faces at edge i and corner i both share the vertex at their position i + 2.
+    std::array<int, 8> one_ring;
+    one_ring.fill(-1);
+
+    if (mesh.FaceSize(face) != 4) {
+        return one_ring;
+    }
+
+    auto align = [&mesh](int h, int i) {
+        for (int step = 0; step < (6 - i) % 4; ++step) {
+            h = mesh.next[h];
+        }
+        return h;
+    };
+
+    for (int i = 0; i < 4; ++i) {
+        const int h = mesh.face_begin[face] + i;
+        const int t = mesh.twin[h];
+        if (t == -1 || mesh.FaceSize(mesh.face[t]) != 4) {
+            continue;
+        }
+
+        // The twin leaves vertex i + 1 of this face.
+        one_ring[i * 2 + 1] = align(t, i);
+
+        // Only regular vertices have a single face diagonally opposite this one.
+        const int v = mesh.vertex[h];
+        if (mesh.vertex_valence[v] != 4 || mesh.OnBoundary(v)) {
+            continue;
+        }
+
+        const int diagonal = mesh.next[mesh.twin[mesh.next[t]]];
+        if (mesh.FaceSize(mesh.face[diagonal]) == 4) {
+            one_ring[i * 2] = align(diagonal, i);
+        }
+    }
+
+    return one_ring;
+}
+
+int RingVertex(const HalfEdgeMesh& mesh, const std::array<int, 8>& one_ring, int ring_face, int vertex) {
+    if (one_ring[ring_face] == -1) {
+        return -1;
+    }
+
+    int h = one_ring[ring_face];
+    for (int step = 0; step < vertex; ++step) {
+        h = mesh.next[h];
+    }
+
+    return mesh.vertex[h];
+}
+
+void GenerateControlPoints(const HalfEdgeMesh& mesh, std::vector<FaceDataPtr>& face_data, int num_threads) {
+    ParallelFor(0, mesh.NumFaces(), num_threads, [&mesh, &face_data](int faces_begin, int faces_end) {
+        for (int f = faces_begin; f < faces_end; ++f) {
+            FaceControlPoints(mesh, f, *face_data[f]);
+        }
+    });
+}
+
+void FaceControlPoints(const HalfEdgeMesh& mesh, int f, FaceData& face) {
+    // Only quads have a B-spline control grid.
+    if (face.Valence() != 4) {
+        face.control_points.fill(-1);
+        return;
+    }
+
+    const std::array<int, 8> one_ring{FaceOneRing(mesh, f)};
+    auto ring_vertex = [&mesh, &one_ring](int ring_face, int vertex) {
+        return RingVertex(mesh, one_ring, ring_face, vertex);
+    };
+
+    face.control_points[0]  = ring_vertex(0, 0);
+    face.control_points[1]  = ring_vertex(1, 0);
+    face.control_points[2]  = ring_vertex(1, 1);
+    face.control_points[3]  = ring_vertex(2, 1);
+
+    face.control_points[4]  = ring_vertex(7, 0);
+    face.control_points[5]  = face.vertices[0];
+    face.control_points[6]  = face.vertices[1];
+    face.control_points[7]  = ring_vertex(3, 1);
+
+    face.control_points[8]  = ring_vertex(7, 3);
+    face.control_points[9]  = face.vertices[3];
+    face.control_points[10] = face.vertices[2];
+    face.control_points[11] = ring_vertex(3, 2);
+
+    face.control_points[12] = ring_vertex(6, 3);
+    face.control_points[13] = ring_vertex(5, 3);
+    face.control_points[14] = ring_vertex(5, 2);
+    face.control_points[15] = ring_vertex(4, 2);
+
+    assert(one_ring[0] == -1 || one_ring[1] == -1 || ring_vertex(0, 1) == ring_vertex(1, 0));
+    assert(one_ring[1] == -1 || one_ring[2] == -1 || ring_vertex(1, 1) == ring_vertex(2, 0));
+    assert(one_ring[0] == -1 || one_ring[7] == -1 || ring_vertex(7, 0) == ring_vertex(0, 3));
+    assert(one_ring[7] == -1 || ring_vertex(7, 1) == face.vertices[0]);
+    assert(one_ring[1] == -1 || ring_vertex(1, 3) == face.vertices[0]);
+    assert(one_ring[0] == -1 || ring_vertex(0, 2) == face.vertices[0]);
+    assert(one_ring[3] == -1 || face.vertices[1] == ring_vertex(3, 0));
+    assert(one_ring[1] == -1 || face.vertices[1] == ring_vertex(1, 2));
+    assert(one_ring[2] == -1 || face.vertices[1] == ring_vertex(2, 3));
+    assert(one_ring[2] == -1 || one_ring[3] == -1 || ring_vertex(3, 1) == ring_vertex(2, 2));
+    assert(one_ring[6] == -1 || one_ring[7] == -1 || ring_vertex(7, 3) == ring_vertex(6, 0));
+    assert(one_ring[7] == -1 || ring_vertex(7, 2) == face.vertices[3]);
+    assert(one_ring[5] == -1 || ring_vertex(5, 0) == face.vertices[3]);
+    assert(one_ring[6] == -1 || ring_vertex(6, 1) == face.vertices[3]);
+    assert(one_ring[3] == -1 || face.vertices[2] == ring_vertex(3, 3));
+    assert(one_ring[5] == -1 || face.vertices[2] == ring_vertex(5, 1));
+    assert(one_ring[4] == -1 || face.vertices[2] == ring_vertex(4, 0));
+    assert(one_ring[3] == -1 || one_ring[4] == -1 || ring_vertex(3, 2) == ring_vertex(4, 1));
+    assert(one_ring[5] == -1 || one_ring[6] == -1 || ring_vertex(6, 2) == ring_vertex(5, 3));
+    assert(one_ring[4] == -1 || one_ring[5] == -1 || ring_vertex(5, 2) == ring_vertex(4, 3));
+}
+
+} // End namespace Subdivision
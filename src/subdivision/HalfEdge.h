@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <array>
+
+#include "subdivision/Connectivity.h"
+
+namespace Subdivision {
+
+// Index-based half-edge connectivity of a polygon mesh. The half-edges of face f are stored contiguously in
+// [face_begin[f], face_begin[f + 1]) in the winding order of the face, and half-edge h runs from vertex[h] to
+// vertex[next[h]]. Half-edges on the mesh boundary have no twin, which is stored as -1.
+struct HalfEdgeMesh {
+    std::vector<std::int32_t> twin;
+    std::vector<std::int32_t> next;
+    std::vector<std::int32_t> vertex;
+    std::vector<std::int32_t> face;
+
+    std::vector<std::int32_t> face_begin;
+
+    // An outgoing half-edge of each vertex, which is the boundary half-edge for vertices on the boundary, so that
+    // walking around the vertex from it with NextAroundVertex() visits every adjacent face. -1 for unused vertices.
+    std::vector<std::int32_t> vertex_edge;
+    std::vector<std::int32_t> vertex_valence;
+    std::vector<std::int32_t> vertex_boundary_edges;
+
+    int NumHalfEdges() const { return vertex.size(); }
+    int NumFaces() const { return face_begin.size() - 1; }
+    int NumVertices() const { return vertex_edge.size(); }
+
+    int FaceSize(int f) const { return face_begin[f + 1] - face_begin[f]; }
+    int Prev(int h) const {
+        const int f = face[h];
+        return face_begin[f] + (h - face_begin[f] + FaceSize(f) - 1) % FaceSize(f);
+    }
+    // The next outgoing half-edge counterclockwise around vertex[h], or -1 if h's face is the last one before the
+    // boundary.
+    int NextAroundVertex(int h) const { return twin[Prev(h)]; }
+    bool OnBoundary(int v) const { return vertex_boundary_edges[v] != 0; }
+};
+
+// How GenerateHalfEdgeMesh finds the twin of each half-edge.
+enum class EdgePairing {
+    HashMap,   // Insert every edge into an unordered_map keyed by EdgeKey.
+    RadixSort  // Radix sort 64-bit (min, max) vertex keys, so twins end up next to each other.
+};
+
+// The num_threads parameters split each stage over that many worker threads. The results do not depend on the
+// number of threads. Edge pairing with an unordered_map always runs on one thread.
+HalfEdgeMesh GenerateHalfEdgeMesh(const std::vector<FaceDataPtr>& face_data, int num_vertices,
+                                  EdgePairing pairing = EdgePairing::RadixSort, int num_threads = 1);
+void PairHalfEdgesHashMap(HalfEdgeMesh& mesh);
+void PairHalfEdgesRadixSort(HalfEdgeMesh& mesh, int num_threads = 1);
+void GenerateHalfEdgeVertexConnectivity(HalfEdgeMesh& mesh, std::vector<FaceDataPtr>& face_data, int num_threads = 1);
+// Only the vertex_edge, vertex_valence and vertex_boundary_edges part, which neither checks the mesh is manifold nor
+// touches the faces.
+void GenerateVertexValences(HalfEdgeMesh& mesh, int num_threads = 1);
+void CountVertexEdges(HalfEdgeMesh& mesh);
+void CountVertexEdgesSorted(HalfEdgeMesh& mesh, int num_threads);
+int VertexBits(const HalfEdgeMesh& mesh, int num_threads);
+
+// Whether the faces around v can be B-spline patches: v has valence 4, or sits on the boundary with one or two faces,
+// and all of its faces are quads.
+bool RegularVertex(const HalfEdgeMesh& mesh, int v);
+
+std::vector<EdgeData> GenerateEdgeData(const HalfEdgeMesh& mesh, std::vector<FaceDataPtr>& face_data);
+
+std::array<int, 8> FaceOneRing(const HalfEdgeMesh& mesh, int face);
+int RingVertex(const HalfEdgeMesh& mesh, const std::array<int, 8>& one_ring, int ring_face, int vertex);
+
+void GenerateControlPoints(const HalfEdgeMesh& mesh, std::vector<FaceDataPtr>& face_data, int num_threads = 1);
+void FaceControlPoints(const HalfEdgeMesh& mesh, int f, FaceData& face);
+
+} // End namespace Subdivision
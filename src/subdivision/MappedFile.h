@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace Subdivision {
+
+// A whole file mapped read-only into memory with mmap, and unmapped again when this is destroyed. Missing and empty
+// files are left unmapped.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool IsMapped() const { return data != nullptr; }
+    const char* Data() const { return data; }
+    std::size_t Size() const { return size; }
+
+private:
+    const char* data = nullptr;
+    std::size_t size = 0;
+};
+
+} // End namespace Subdivision
@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "subdivision/MeshCache.h"
+
+namespace Subdivision {
+
+namespace {
+
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 is not 3 packed floats on this platform.");
+static_assert(sizeof(PatchBounds) == 10 * sizeof(float), "PatchBounds is not 10 packed floats on this platform.");
+static_assert(std::is_trivially_copyable<PatchBounds>::value, "PatchBounds can't be copied as bytes.");
+
+constexpr char cache_magic[8] = {'S', 'U', 'B', 'D', 'M', 'E', 'S', 'H'};
+constexpr std::uint32_t cache_byte_order = 0x01020304;
+constexpr std::size_t section_alignment = 16;
+
+std::size_t AlignSection(std::size_t offset) {
+    return (offset + section_alignment - 1) / section_alignment * section_alignment;
+}
+
+// Where each array of a cache starts, and where the file ends.
+struct CacheSections {
+    std::size_t vertices, indices, patch_bounds, patch_flags, patch_levels, stencil_offsets, stencil_indices,
+                stencil_weights, end;
+
+    explicit CacheSections(const MeshCacheHeader& header) {
+        const std::size_t num_offsets = (header.num_stencils == 0) ? 0 : header.num_stencils + 1;
+        vertices = AlignSection(sizeof(MeshCacheHeader));
+        indices = AlignSection(vertices + header.num_vertices * sizeof(glm::vec3));
+        patch_bounds = AlignSection(indices + header.num_indices * sizeof(int));
+        patch_flags = AlignSection(patch_bounds + header.num_patch_bounds * sizeof(PatchBounds));
+        patch_levels = AlignSection(patch_flags + header.num_patch_flags);
+        stencil_offsets = AlignSection(patch_levels + header.num_patch_flags);
+        stencil_indices = AlignSection(stencil_offsets + num_offsets * sizeof(int));
+        stencil_weights = AlignSection(stencil_indices + header.num_stencil_weights * sizeof(int));
+        end = stencil_weights + header.num_stencil_weights * sizeof(float);
+    }
+};
+
+// Whether the counts of a header fit in a file of the given size and agree with each other. Checked before any offsets
+// are computed from them, so the counts of a damaged or crafted file can't overflow into offsets which look valid.
+bool ValidCounts(const MeshCacheHeader& header, std::size_t size) {
+    if (header.num_vertices > size / sizeof(glm::vec3)
+            || header.num_indices > size / sizeof(int)
+            || header.num_patch_bounds > size / sizeof(PatchBounds)
+            || header.num_patch_flags > size
+            || header.num_stencils >= size / sizeof(int)
+            || header.num_stencil_weights > size / sizeof(float)) {
+        return false;
+    }
+
+    // Every patch has 16 control points and a bounds, and optionally a flag and level.
+    if (header.num_indices != 16 * header.num_patch_bounds
+            || (header.num_patch_flags != 0 && header.num_patch_flags != header.num_patch_bounds)) {
+        return false;
+    }
+
+    return header.num_stencils != 0 || (header.num_stencil_weights == 0 && header.num_control_vertices == 0);
+}
+
+std::uint64_t HashBytes(std::uint64_t hash, const void* bytes, std::size_t size) {
+    const unsigned char* byte = static_cast<const unsigned char*>(bytes);
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ byte[i]) * 0x100000001b3;
+    }
+
+    return hash;
+}
+
+template<typename T>
+void WriteSection(std::ofstream& file, std::size_t offset, const T* data, std::size_t count) {
+    static const char padding[section_alignment] = {};
+    file.write(padding, offset - file.tellp());
+    file.write(reinterpret_cast<const char*>(data), count * sizeof(T));
+}
+
+// Creates a new, uniquely named file next to filename, and returns its name.
+std::string MakeTempFile(const std::string& filename) {
+    std::vector<char> temp_filename(filename.cbegin(), filename.cend());
+    const std::string suffix = ".tmp.XXXXXX";
+    temp_filename.insert(temp_filename.end(), suffix.cbegin(), suffix.cend());
+    temp_filename.push_back('\0');
+
+    const int fd = mkstemp(temp_filename.data());
+    if (fd == -1) {
+        throw std::runtime_error("Error when attempting to write mesh cache " + filename);
+    }
+    // mkstemp() only lets the owner read the file, while the cache is meant to be as readable as any other file.
+    fchmod(fd, 0644);
+    close(fd);
+
+    return temp_filename.data();
+}
+
+} // End anonymous namespace
+
+std::uint64_t MeshCacheKey(const std::string& obj_filename, const RefinementOptions& options) {
+    const MappedFile obj_file{obj_filename};
+    if (!obj_file.IsMapped()) {
+        throw std::runtime_error("Error when attempting to read " + obj_filename);
+    }
+
+    std::uint64_t key = HashBytes(0xcbf29ce484222325, obj_file.Data(), obj_file.Size());
+    key = HashBytes(key, &mesh_cache_version, sizeof(mesh_cache_version));
+    key = HashBytes(key, &options.max_depth, sizeof(options.max_depth));
+    return HashBytes(key, options.face_priorities.data(), options.face_priorities.size() * sizeof(float));
+}
+
+std::string MeshCacheFilename(const std::string& cache_directory, std::uint64_t key) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.subdmesh", static_cast<unsigned long long>(key));
+
+    return cache_directory + "/" + name;
+}
+
+void WriteMeshCache(const std::string& cache_filename, std::uint64_t key, const IndexedMesh& mesh,
+                    const StencilTable* stencils) {
+    if (mesh.indices.size() != 16 * mesh.patch_bounds.size()) {
+        throw std::runtime_error("Can't cache a mesh without the bounds of each of its patches.");
+    }
+
+    MeshCacheHeader header{};
+    std::memcpy(header.magic, cache_magic, sizeof(cache_magic));
+    header.version = mesh_cache_version;
+    header.byte_order = cache_byte_order;
+    header.key = key;
+    header.num_vertices = mesh.vertices.size();
+    header.num_indices = mesh.indices.size();
+    header.num_patch_bounds = mesh.patch_bounds.size();
+    if (mesh.patch_flags.size() == mesh.patch_bounds.size() && mesh.patch_levels.size() == mesh.patch_bounds.size()) {
+        header.num_patch_flags = mesh.patch_bounds.size();
+    }
+    if (stencils != nullptr && stencils->NumStencils() != 0) {
+        header.num_stencils = stencils->NumStencils();
+        header.num_stencil_weights = stencils->weights.size();
+        header.num_control_vertices = stencils->num_control_vertices;
+    }
+
+    // Written next to the cache and then renamed over it, so a cache is never mapped half written. Each writer gets a
+    // temporary file of its own, so processes warming the same cache don't write into each other's files.
+    const std::string temp_filename = MakeTempFile(cache_filename);
+    std::ofstream file{temp_filename, std::ios::binary | std::ios::trunc};
+
+    const CacheSections sections{header};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    WriteSection(file, sections.vertices, mesh.vertices.data(), mesh.vertices.size());
+    WriteSection(file, sections.indices, mesh.indices.data(), mesh.indices.size());
+    WriteSection(file, sections.patch_bounds, mesh.patch_bounds.data(), mesh.patch_bounds.size());
+    WriteSection(file, sections.patch_flags, mesh.patch_flags.data(), header.num_patch_flags);
+    WriteSection(file, sections.patch_levels, mesh.patch_levels.data(), header.num_patch_flags);
+    if (header.num_stencils != 0) {
+        WriteSection(file, sections.stencil_offsets, stencils->offsets.data(), stencils->offsets.size());
+        WriteSection(file, sections.stencil_indices, stencils->indices.data(), stencils->indices.size());
+        WriteSection(file, sections.stencil_weights, stencils->weights.data(), stencils->weights.size());
+    }
+    // Sections left empty at the end are still aligned, so pad the file out to where they end.
+    WriteSection(file, sections.end, static_cast<const char*>(nullptr), 0);
+
+    file.close();
+    if (!file || std::rename(temp_filename.c_str(), cache_filename.c_str()) != 0) {
+        std::remove(temp_filename.c_str());
+        throw std::runtime_error("Error when attempting to write mesh cache " + cache_filename);
+    }
+}
+
+MappedMeshCache::MappedMeshCache(const std::string& cache_filename)
+        : file(cache_filename)
+        , data(file.Data()) {
+    if (!file.IsMapped()) {
+        return;
+    }
+
+    const std::size_t size = file.Size();
+    const MeshCacheHeader* mapped_header = reinterpret_cast<const MeshCacheHeader*>(data);
+    if (size < sizeof(MeshCacheHeader)
+            || std::memcmp(mapped_header->magic, cache_magic, sizeof(cache_magic)) != 0
+            || mapped_header->version != mesh_cache_version
+            || mapped_header->byte_order != cache_byte_order
+            || !ValidCounts(*mapped_header, size)
+            || CacheSections{*mapped_header}.end != size) {
+        return;
+    }
+
+    header = mapped_header;
+}
+
+const glm::vec3* MappedMeshCache::Vertices() const {
+    return reinterpret_cast<const glm::vec3*>(data + CacheSections{*header}.vertices);
+}
+
+const int* MappedMeshCache::Indices() const {
+    return reinterpret_cast<const int*>(data + CacheSections{*header}.indices);
+}
+
+const PatchBounds* MappedMeshCache::Bounds() const {
+    return reinterpret_cast<const PatchBounds*>(data + CacheSections{*header}.patch_bounds);
+}
+
+const std::uint8_t* MappedMeshCache::PatchFlags() const {
+    return reinterpret_cast<const std::uint8_t*>(data + CacheSections{*header}.patch_flags);
+}
+
+const std::uint8_t* MappedMeshCache::PatchLevels() const {
+    return reinterpret_cast<const std::uint8_t*>(data + CacheSections{*header}.patch_levels);
+}
+
+IndexedMesh MappedMeshCache::ToIndexedMesh() const {
+    return {std::vector<glm::vec3>(Vertices(), Vertices() + NumVertices()),
+            std::vector<int>(Indices(), Indices() + NumIndices()),
+            std::vector<PatchBounds>(Bounds(), Bounds() + NumPatchBounds()),
+            std::vector<std::uint8_t>(PatchFlags(), PatchFlags() + NumPatchFlags()),
+            std::vector<std::uint8_t>(PatchLevels(), PatchLevels() + NumPatchFlags())};
+}
+
+StencilTable MappedMeshCache::ToStencilTable() const {
+    StencilTable table;
+    if (!HasStencils()) {
+        return table;
+    }
+
+    const CacheSections sections{*header};
+    const int* offsets = reinterpret_cast<const int*>(data + sections.stencil_offsets);
+    const int* indices = reinterpret_cast<const int*>(data + sections.stencil_indices);
+    const float* weights = reinterpret_cast<const float*>(data + sections.stencil_weights);
+
+    // The offsets run from 0 to the number of weights, and every index is a control vertex, or the table would read
+    // outside its own arrays or the control vertices.
+    const std::uint64_t num_weights = header->num_stencil_weights;
+    if (offsets[0] != 0 || static_cast<std::uint64_t>(offsets[header->num_stencils]) != num_weights
+            || !std::is_sorted(offsets, offsets + header->num_stencils + 1)
+            || std::any_of(indices, indices + num_weights, [this](int index) {
+                   return index < 0 || static_cast<std::uint64_t>(index) >= header->num_control_vertices;
+               })) {
+        throw std::runtime_error("The stencil table of a mesh cache is corrupt.");
+    }
+
+    table.num_control_vertices = header->num_control_vertices;
+    table.offsets.assign(offsets, offsets + header->num_stencils + 1);
+    table.indices.assign(indices, indices + header->num_stencil_weights);
+    table.weights.assign(weights, weights + header->num_stencil_weights);
+
+    return table;
+}
+
+IndexedMesh SubdivideMeshCached(const std::string& obj_filename, const std::string& cache_directory,
+                                int num_threads, const RefinementOptions& options) {
+    const std::uint64_t key = MeshCacheKey(obj_filename, options);
+    const std::string cache_filename = MeshCacheFilename(cache_directory, key);
+    {
+        const MappedMeshCache cache{cache_filename};
+        if (cache.IsValid() && cache.Key() == key) {
+            return cache.ToIndexedMesh();
+        }
+    }
+
+    IndexedMesh mesh{SubdivideMesh(LoadObjFile(obj_filename, num_threads), num_threads, options)};
+    // Failing to write the cache only costs the next start its speed.
+    try {
+        WriteMeshCache(cache_filename, key, mesh);
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << std::endl;
+    }
+
+    return mesh;
+}
+
+} // End namespace Subdivision
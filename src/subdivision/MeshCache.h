@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include "subdivision/MappedFile.h"
+#include "subdivision/ObjMesh.h"
+#include "subdivision/Stencil.h"
+#include "subdivision/Subdivision.h"
+
+namespace Subdivision {
+
+// Bumped whenever the layout of a cache file or the output of the refinement changes, so stale caches are rebuilt.
+constexpr std::uint32_t mesh_cache_version = 2;
+
+// A subdivided mesh as a binary file, which is mapped straight into memory to start without parsing the .obj file or
+// refining it. A header of counts is followed by the arrays of the mesh, each starting on a 16 byte boundary:
+// vertices, indices, patch bounds, patch flags and levels, and optionally the stencil table, as offsets, indices and
+// weights. Everything is stored in the byte order of the machine which wrote it, which the header records.
+struct MeshCacheHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t key;
+
+    std::uint64_t num_vertices;
+    std::uint64_t num_indices;
+    std::uint64_t num_patch_bounds;
+    // Zero when the mesh has no patch flags and levels, otherwise num_patch_bounds.
+    std::uint64_t num_patch_flags;
+    // Zero when the cache holds no stencil table.
+    std::uint64_t num_stencils;
+    std::uint64_t num_stencil_weights;
+    std::uint64_t num_control_vertices;
+};
+
+// The key of the cache of an .obj file refined with the given options: a 64-bit FNV-1a hash of the file's bytes, the
+// options and mesh_cache_version.
+std::uint64_t MeshCacheKey(const std::string& obj_filename, const RefinementOptions& options);
+// The cache file of a key in cache_directory, named after the key in hex.
+std::string MeshCacheFilename(const std::string& cache_directory, std::uint64_t key);
+
+// Writes a cache of mesh, and of its stencil table if one is given, to cache_filename. The mesh must have the bounds of
+// each of its patches, as SubdivideMesh() gives it.
+void WriteMeshCache(const std::string& cache_filename, std::uint64_t key, const IndexedMesh& mesh,
+                    const StencilTable* stencils = nullptr);
+
+// A cache file mapped read-only into memory. The arrays point into the mapping, and are only valid as long as it is.
+class MappedMeshCache {
+public:
+    // Maps cache_filename. The cache is left invalid if the file is missing, or isn't a complete cache of this
+    // version and byte order whose counts agree with each other and the size of the file.
+    explicit MappedMeshCache(const std::string& cache_filename);
+
+    bool IsValid() const { return header != nullptr; }
+    std::uint64_t Key() const { return header->key; }
+
+    int NumVertices() const { return header->num_vertices; }
+    int NumIndices() const { return header->num_indices; }
+    int NumPatchBounds() const { return header->num_patch_bounds; }
+    int NumPatchFlags() const { return header->num_patch_flags; }
+    bool HasStencils() const { return header->num_stencils != 0; }
+
+    const glm::vec3* Vertices() const;
+    const int* Indices() const;
+    const PatchBounds* Bounds() const;
+    const std::uint8_t* PatchFlags() const;
+    const std::uint8_t* PatchLevels() const;
+
+    // Copies of the arrays, for code which takes an IndexedMesh or a StencilTable. ToStencilTable() checks the
+    // stencils only read their own weights and the control vertices, and throws std::runtime_error if not.
+    IndexedMesh ToIndexedMesh() const;
+    StencilTable ToStencilTable() const;
+
+private:
+    const MappedFile file;
+    const char* data;
+    const MeshCacheHeader* header = nullptr;
+};
+
+// SubdivideMesh() of an .obj file, through a cache in cache_directory. A cache with the key of the file and options is
+// mapped instead of refining the mesh. Otherwise the mesh is refined, and its cache written for the next time.
+IndexedMesh SubdivideMeshCached(const std::string& obj_filename, const std::string& cache_directory,
+                                int num_threads = 1, const RefinementOptions& options = {});
+
+} // End namespace Subdivision
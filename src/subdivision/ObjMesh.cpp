@@ -0,0 +1,374 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <iostream>
+#include <utility>
+
+#include "subdivision/ObjMesh.h"
+#include "subdivision/MappedFile.h"
+#include "subdivision/Parallel.h"
+
+namespace Subdivision {
+
+namespace {
+
+// The smallest chunk of an .obj file worth a thread of its own.
+constexpr int min_obj_chunk_bytes = 1 << 16;
+
+// A run of whole lines of an .obj file, and what parsing them found.
+struct ObjChunk {
+    const char* begin;
+    const char* end;
+
+    // The positions and normals of the chunk are counted before it is parsed, so it knows the index of its first
+    // ones, which negative face indices count back from.
+    int num_positions = 0;
+    int num_normals = 0;
+    int first_position = 0;
+    int first_normal = 0;
+
+    std::vector<tinyobj::index_t> indices;
+    std::vector<unsigned char> num_face_vertices;
+};
+
+bool IsBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+const char* SkipBlanks(const char* p, const char* end) {
+    while (p != end && IsBlank(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+const char* NextLine(const char* p, const char* end) {
+    const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    return (newline == nullptr) ? end : newline + 1;
+}
+
+// The kind of line at p, which starts after any blanks: 'v' for a position, 'n' for a normal, 'f' for a face, or 0
+// for anything else.
+char LineKind(const char* p, const char* end) {
+    if (end - p < 2) {
+        return 0;
+    }
+    if (p[0] == 'f' && IsBlank(p[1])) {
+        return 'f';
+    }
+    if (p[0] == 'v' && IsBlank(p[1])) {
+        return 'v';
+    }
+    if (p[0] == 'v' && p[1] == 'n' && end - p > 2 && IsBlank(p[2])) {
+        return 'n';
+    }
+    return 0;
+}
+
+// Parses a decimal number such as -1.25e-3 at p. Returns the end of the number, or nullptr if there is none. The
+// first 19 significant digits are kept, more than a float can tell apart, and scaled by an exact power of ten where
+// there is one, so almost every value rounds the same as strtof.
+const char* ParseFloat(const char* p, const char* end, float& value) {
+    static const double powers_of_ten[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                           1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    bool negative = false;
+    if (p != end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    std::uint64_t mantissa = 0;
+    int significant_digits = 0;
+    int exponent = 0;
+    bool any_digits = false;
+    for (; p != end && IsDigit(*p); ++p) {
+        any_digits = true;
+        if (significant_digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            significant_digits += (mantissa != 0);
+        } else {
+            ++exponent;
+        }
+    }
+    if (p != end && *p == '.') {
+        for (++p; p != end && IsDigit(*p); ++p) {
+            any_digits = true;
+            if (significant_digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                significant_digits += (mantissa != 0);
+                --exponent;
+            }
+        }
+    }
+    if (!any_digits) {
+        return nullptr;
+    }
+
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negative_exponent = false;
+        if (p != end && (*p == '-' || *p == '+')) {
+            negative_exponent = (*p == '-');
+            ++p;
+        }
+        if (p == end || !IsDigit(*p)) {
+            return nullptr;
+        }
+
+        int written_exponent = 0;
+        for (; p != end && IsDigit(*p); ++p) {
+            written_exponent = std::min(written_exponent * 10 + (*p - '0'), 100000);
+        }
+        exponent += negative_exponent ? -written_exponent : written_exponent;
+    }
+
+    double result = mantissa;
+    if (exponent < 0) {
+        result /= (exponent >= -22) ? powers_of_ten[-exponent] : std::pow(10.0, -exponent);
+    } else if (exponent > 0) {
+        result *= (exponent <= 22) ? powers_of_ten[exponent] : std::pow(10.0, exponent);
+    }
+
+    value = static_cast<float>(negative ? -result : result);
+    return p;
+}
+
+// Parses a signed integer at p. Returns the end of it, or nullptr if there is none.
+const char* ParseIndex(const char* p, const char* end, int& value) {
+    const bool negative = (p != end && *p == '-');
+    if (negative) {
+        ++p;
+    }
+    if (p == end || !IsDigit(*p)) {
+        return nullptr;
+    }
+
+    std::int64_t index = 0;
+    for (; p != end && IsDigit(*p); ++p) {
+        index = std::min<std::int64_t>(index * 10 + (*p - '0'), INT32_MAX);
+    }
+
+    value = static_cast<int>(negative ? -index : index);
+    return p;
+}
+
+void CountObjChunk(ObjChunk& chunk) {
+    for (const char* line = chunk.begin; line != chunk.end; line = NextLine(line, chunk.end)) {
+        const char kind = LineKind(SkipBlanks(line, chunk.end), chunk.end);
+        chunk.num_positions += (kind == 'v');
+        chunk.num_normals += (kind == 'n');
+    }
+}
+
+// Parses the positions and normals of the chunk into their place in attrs, and its faces into the chunk.
+void ParseObjChunk(ObjChunk& chunk, tinyobj::attrib_t& attrs, const char* file_begin,
+                   const std::string& obj_filename) {
+    const int total_positions = attrs.vertices.size() / 3;
+    const int total_normals = attrs.normals.size() / 3;
+    int position = chunk.first_position;
+    int normal = chunk.first_normal;
+
+    for (const char* line = chunk.begin; line != chunk.end;) {
+        const char* line_end = NextLine(line, chunk.end);
+        const char* p = SkipBlanks(line, line_end);
+        auto fail = [&](const std::string& what) {
+            throw std::runtime_error("Error when parsing " + obj_filename + ": " + what + " at byte "
+                                     + std::to_string(p - file_begin));
+        };
+
+        const char kind = LineKind(p, line_end);
+        if (kind == 'v' || kind == 'n') {
+            float* coords = (kind == 'v') ? &attrs.vertices[3 * position++] : &attrs.normals[3 * normal++];
+            p += (kind == 'v') ? 1 : 2;
+            for (int c = 0; c < 3; ++c) {
+                p = ParseFloat(SkipBlanks(p, line_end), line_end, coords[c]);
+                if (p == nullptr) {
+                    p = line;
+                    fail("expected three coordinates");
+                }
+            }
+        } else if (kind == 'f') {
+            // Relative indices count back from the last position or normal before the face.
+            auto resolve = [&](int index, int count, int total) {
+                const int resolved = (index > 0) ? index - 1 : count + index;
+                if (index == 0 || resolved < 0 || resolved >= total) {
+                    fail("index " + std::to_string(index) + " out of range");
+                }
+                return resolved;
+            };
+
+            int num_vertices = 0;
+            for (p = SkipBlanks(p + 1, line_end); p != line_end && *p != '\n' && *p != '#';
+                 p = SkipBlanks(p, line_end)) {
+                tinyobj::index_t index{-1, -1, -1};
+                int value = 0;
+                const char* next = ParseIndex(p, line_end, value);
+                if (next == nullptr) {
+                    fail("expected a vertex index");
+                }
+                index.vertex_index = resolve(value, position, total_positions);
+                p = next;
+
+                // Either v/vt, v/vt/vn or v//vn. Texture coordinates are skipped.
+                if (p != line_end && *p == '/') {
+                    ++p;
+                    if (p != line_end && *p != '/') {
+                        next = ParseIndex(p, line_end, value);
+                        if (next == nullptr) {
+                            fail("expected a texture coordinate index");
+                        }
+                        p = next;
+                    }
+                    if (p != line_end && *p == '/') {
+                        next = ParseIndex(++p, line_end, value);
+                        if (next == nullptr) {
+                            fail("expected a normal index");
+                        }
+                        index.normal_index = resolve(value, normal, total_normals);
+                        p = next;
+                    }
+                }
+
+                chunk.indices.push_back(index);
+                ++num_vertices;
+            }
+
+            if (num_vertices < 3 || num_vertices > 255) {
+                p = line;
+                fail("face with " + std::to_string(num_vertices) + " vertices");
+            }
+            chunk.num_face_vertices.push_back(num_vertices);
+        }
+
+        line = line_end;
+    }
+}
+
+} // End anonymous namespace
+
+TinyObjMesh::TinyObjMesh(tinyobj::attrib_t attrib, std::vector<tinyobj::mesh_t> mesh)
+        : attrs(std::move(attrib))
+        , meshes(std::move(mesh)) {}
+
+IndexedMesh::IndexedMesh(std::vector<glm::vec3> verts, std::vector<int> indexes, std::vector<PatchBounds> bounds,
+                         std::vector<std::uint8_t> flags, std::vector<std::uint8_t> levels)
+        : vertices(std::move(verts))
+        , indices(std::move(indexes))
+        , patch_bounds(std::move(bounds))
+        , patch_flags(std::move(flags))
+        , patch_levels(std::move(levels)) {}
+
+TinyObjMesh LoadTinyObjFromFile(const std::string& obj_filename) {
+    tinyobj::attrib_t attributes;
+    std::vector<tinyobj::shape_t> shapes;
+    // I don't load materials right now, but this is still needed to call tinyobj::LoadObj.
+    std::vector<tinyobj::material_t> materials;
+
+    std::string err_msg;
+    bool success = tinyobj::LoadObj(&attributes, &shapes, &materials, &err_msg, obj_filename.c_str(), nullptr, false);
+    if (!err_msg.empty()) {
+        std::cerr << err_msg << std::endl;
+    }
+    if (!success) {
+        throw std::runtime_error("Error when attempting to load mesh from " + obj_filename);
+    }
+
+    // Haven't found any use for the name field in the shape_t struct, so I just grab the mesh_t's.
+    std::vector<tinyobj::mesh_t> meshes;
+    std::transform(shapes.cbegin(), shapes.cend(), std::back_inserter(meshes),
+                   [](const tinyobj::shape_t& shape) { return shape.mesh; });
+
+    return {std::move(attributes), std::move(meshes)};
+}
+
+TinyObjMesh LoadObjFile(const std::string& obj_filename, int num_threads) {
+    const MappedFile file{obj_filename};
+    if (!file.IsMapped()) {
+        throw std::runtime_error("Error when attempting to load mesh from " + obj_filename);
+    }
+
+    // Split the file into chunks of about the same size, each ending after a newline.
+    const int num_chunks = ChunkCount(std::min<std::size_t>(file.Size(), INT32_MAX), num_threads, min_obj_chunk_bytes);
+    const char* const file_end = file.Data() + file.Size();
+    std::vector<ObjChunk> chunks(num_chunks);
+    const char* chunk_begin = file.Data();
+    for (int c = 0; c < num_chunks; ++c) {
+        const char* chunk_end = (c + 1 == num_chunks)
+                              ? file_end
+                              : NextLine(file.Data() + file.Size() / num_chunks * (c + 1) - 1, file_end);
+        chunks[c].begin = chunk_begin;
+        chunks[c].end = std::max(chunk_begin, chunk_end);
+        chunk_begin = chunks[c].end;
+    }
+
+    ParallelChunks(num_chunks, [&chunks](int c) { CountObjChunk(chunks[c]); });
+
+    int num_positions = 0;
+    int num_normals = 0;
+    for (auto& chunk : chunks) {
+        chunk.first_position = num_positions;
+        chunk.first_normal = num_normals;
+        num_positions += chunk.num_positions;
+        num_normals += chunk.num_normals;
+    }
+
+    tinyobj::attrib_t attrs;
+    attrs.vertices.resize(3 * num_positions);
+    attrs.normals.resize(3 * num_normals);
+    ParallelChunks(num_chunks, [&](int c) { ParseObjChunk(chunks[c], attrs, file.Data(), obj_filename); });
+
+    // Gather the faces of the chunks in file order.
+    std::vector<tinyobj::mesh_t> meshes(1);
+    tinyobj::mesh_t& mesh = meshes[0];
+    std::vector<std::size_t> first_indices(num_chunks + 1, 0);
+    std::vector<std::size_t> first_faces(num_chunks + 1, 0);
+    for (int c = 0; c < num_chunks; ++c) {
+        first_indices[c + 1] = first_indices[c] + chunks[c].indices.size();
+        first_faces[c + 1] = first_faces[c] + chunks[c].num_face_vertices.size();
+    }
+
+    mesh.indices.resize(first_indices[num_chunks]);
+    mesh.num_face_vertices.resize(first_faces[num_chunks]);
+    ParallelChunks(num_chunks, [&](int c) {
+        std::copy(chunks[c].indices.cbegin(), chunks[c].indices.cend(), mesh.indices.begin() + first_indices[c]);
+        std::copy(chunks[c].num_face_vertices.cbegin(), chunks[c].num_face_vertices.cend(),
+                  mesh.num_face_vertices.begin() + first_faces[c]);
+    });
+
+    return {std::move(attrs), std::move(meshes)};
+}
+
+std::vector<glm::vec3> PolygonSoup(const TinyObjMesh& tiny_obj) {
+    std::vector<glm::vec3> mesh_data;
+
+    // Usually only one mesh in an .obj file, but iterate over them just in case.
+    for (const auto& mesh : tiny_obj.meshes) {
+        // Iterate over each face in the mesh.
+        std::size_t face_offset = 0;
+        for (const auto& valence : mesh.num_face_vertices) {
+            // Get the vertices and normals for each face from the provided indices.
+            for(std::size_t v = 0; v < valence; ++v) {
+                tinyobj::index_t idx = mesh.indices[face_offset + v];
+                mesh_data.emplace_back(tiny_obj.attrs.vertices[3 * idx.vertex_index + 0],
+                                       tiny_obj.attrs.vertices[3 * idx.vertex_index + 1],
+                                       tiny_obj.attrs.vertices[3 * idx.vertex_index + 2]);
+                mesh_data.emplace_back(tiny_obj.attrs.normals[3 * idx.normal_index + 0],
+                                       tiny_obj.attrs.normals[3 * idx.normal_index + 1],
+                                       tiny_obj.attrs.normals[3 * idx.normal_index + 2]);
+            }
+
+            face_offset += valence;
+        }
+    }
+
+    return mesh_data;
+}
+
+} // End namespace Subdivision
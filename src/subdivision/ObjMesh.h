@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include "externals/tiny_obj_loader.h"
+
+namespace Subdivision {
+
+struct TinyObjMesh {
+    tinyobj::attrib_t attrs;
+    std::vector<tinyobj::mesh_t> meshes;
+
+    TinyObjMesh(tinyobj::attrib_t attrib, std::vector<tinyobj::mesh_t> mesh);
+};
+
+// The bounds of a B-spline patch, for culling it before it is tessellated. By the convex hull property the patch lies
+// in the box around its control points, and its normal, as the tessellation evaluation shader computes it, is within
+// cone_angle radians of cone_axis. A cone_angle of pi means the normals could point anywhere.
+struct PatchBounds {
+    glm::vec3 box_min;
+    glm::vec3 box_max;
+    glm::vec3 cone_axis;
+    float cone_angle;
+};
+
+struct IndexedMesh {
+    std::vector<glm::vec3> vertices;
+    std::vector<int> indices;
+    // One per 16 indices when the mesh is made of B-spline patches, otherwise empty.
+    std::vector<PatchBounds> patch_bounds;
+    // The flags and levels of each patch from its PatchTable, if the mesh came from one, otherwise empty.
+    std::vector<std::uint8_t> patch_flags;
+    std::vector<std::uint8_t> patch_levels;
+
+    IndexedMesh(std::vector<glm::vec3> verts, std::vector<int> indexes, std::vector<PatchBounds> bounds = {},
+                std::vector<std::uint8_t> flags = {}, std::vector<std::uint8_t> levels = {});
+};
+
+TinyObjMesh LoadTinyObjFromFile(const std::string& obj_filename);
+// Loads only the positions, normals and faces of an .obj file, which is all the subdivision and the viewer use, as one
+// mesh with the faces in file order. The file is mapped and split into chunks of whole lines, which are parsed on up to
+// num_threads threads straight into the arrays of the TinyObjMesh. Texture coordinates, groups and materials are
+// skipped, so every texcoord_index is -1.
+TinyObjMesh LoadObjFile(const std::string& obj_filename, int num_threads = 1);
+std::vector<glm::vec3> PolygonSoup(const TinyObjMesh& tiny_obj);
+
+} // End namespace Subdivision
@@ -0,0 +1,54 @@
+#include "subdivision/Parallel.h"
+
+namespace Subdivision {
+
+void RadixSort(std::vector<std::uint64_t>& keys, std::vector<std::int32_t>& values, int key_bits, int num_threads) {
+    constexpr int digit_bits = 11;
+    constexpr int num_buckets = 1 << digit_bits;
+    constexpr std::uint64_t digit_mask = num_buckets - 1;
+
+    const int count = keys.size();
+    const int num_chunks = ChunkCount(count, num_threads);
+
+    std::vector<std::uint64_t> sorted_keys(count);
+    std::vector<std::int32_t> sorted_values(count);
+
+    // Each chunk gets its own bucket offsets. Chunks are scattered in order within each bucket, which keeps every
+    // pass stable no matter how many threads there are.
+    std::vector<std::vector<int>> bucket_offsets(num_chunks, std::vector<int>(num_buckets));
+
+    for (int shift = 0; shift < key_bits; shift += digit_bits) {
+        ParallelChunks(num_chunks, [&](int chunk) {
+            auto& offsets = bucket_offsets[chunk];
+            std::fill(offsets.begin(), offsets.end(), 0);
+            const int chunk_end = ChunkBegin(0, count, num_chunks, chunk + 1);
+            for (int i = ChunkBegin(0, count, num_chunks, chunk); i < chunk_end; ++i) {
+                ++offsets[(keys[i] >> shift) & digit_mask];
+            }
+        });
+
+        int total = 0;
+        for (int bucket = 0; bucket < num_buckets; ++bucket) {
+            for (auto& offsets : bucket_offsets) {
+                const int bucket_count = offsets[bucket];
+                offsets[bucket] = total;
+                total += bucket_count;
+            }
+        }
+
+        ParallelChunks(num_chunks, [&](int chunk) {
+            auto& offsets = bucket_offsets[chunk];
+            const int chunk_end = ChunkBegin(0, count, num_chunks, chunk + 1);
+            for (int i = ChunkBegin(0, count, num_chunks, chunk); i < chunk_end; ++i) {
+                const int destination = offsets[(keys[i] >> shift) & digit_mask]++;
+                sorted_keys[destination] = keys[i];
+                sorted_values[destination] = values[i];
+            }
+        });
+
+        keys.swap(sorted_keys);
+        values.swap(sorted_values);
+    }
+}
+
+} // End namespace Subdivision
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace Subdivision {
+
+// The number of chunks to split count items into for num_threads workers, keeping each chunk at least min_chunk
+// items long so small inputs don't pay for threads they can't use.
+inline int ChunkCount(int count, int num_threads, int min_chunk = 1024) {
+    return std::max(1, std::min(num_threads, count / min_chunk));
+}
+
+// The first item of a chunk of [begin, end). Passing chunk == num_chunks gives end.
+inline int ChunkBegin(int begin, int end, int num_chunks, int chunk) {
+    return begin + static_cast<int>(static_cast<std::int64_t>(end - begin) * chunk / num_chunks);
+}
+
+// Runs func(chunk) for every chunk in [0, num_chunks), each on its own thread. The calling thread runs the first
+// chunk, and any chunks whose thread couldn't be started. If any chunk throws, the first exception is rethrown here
+// once every thread has finished.
+template<typename Func>
+void ParallelChunks(int num_chunks, Func func) {
+    if (num_chunks == 1) {
+        func(0);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(num_chunks);
+    auto run_chunk = [&func, &errors](int chunk) {
+        try {
+            func(chunk);
+        } catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    };
+
+    // Reserving up front means the only thing that can fail below is starting a thread. The started threads are
+    // still joined in that case, so the remaining chunks are run here instead.
+    std::vector<std::thread> workers;
+    workers.reserve(num_chunks - 1);
+    int first_inline_chunk = num_chunks;
+    for (int chunk = 1; chunk < num_chunks; ++chunk) {
+        try {
+            workers.emplace_back(run_chunk, chunk);
+        } catch (...) {
+            first_inline_chunk = chunk;
+            break;
+        }
+    }
+
+    run_chunk(0);
+    for (int chunk = first_inline_chunk; chunk < num_chunks; ++chunk) {
+        run_chunk(chunk);
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+// Runs func(chunk_begin, chunk_end) over contiguous chunks of [begin, end) on up to num_threads threads.
+template<typename Func>
+void ParallelFor(int begin, int end, int num_threads, Func func) {
+    if (end <= begin) {
+        return;
+    }
+
+    const int num_chunks = ChunkCount(end - begin, num_threads);
+    ParallelChunks(num_chunks, [begin, end, num_chunks, &func](int chunk) {
+        func(ChunkBegin(begin, end, num_chunks, chunk), ChunkBegin(begin, end, num_chunks, chunk + 1));
+    });
+}
+
+// Stable least significant digit radix sort of keys by their low key_bits bits, moving values along with them.
+void RadixSort(std::vector<std::uint64_t>& keys, std::vector<std::int32_t>& values, int key_bits, int num_threads);
+
+} // End namespace Subdivision
@@ -0,0 +1,155 @@
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "subdivision/PatchKernel.h"
+
+namespace Subdivision {
+
+namespace {
+
+// One float from each patch of a batch. The kernel is written once against this interface and instantiated for each
+// instruction set. No fused multiply-adds are used, so all of them round identically.
+struct ScalarLanes {
+    float v[patch_batch_size];
+
+    static ScalarLanes Load(const float* p) {
+        ScalarLanes r;
+        for (int l = 0; l < patch_batch_size; ++l) r.v[l] = p[l];
+        return r;
+    }
+    void Store(float* p) const {
+        for (int l = 0; l < patch_batch_size; ++l) p[l] = v[l];
+    }
+    static ScalarLanes Set(float s) {
+        ScalarLanes r;
+        for (int l = 0; l < patch_batch_size; ++l) r.v[l] = s;
+        return r;
+    }
+    friend ScalarLanes operator+(ScalarLanes a, const ScalarLanes& b) {
+        for (int l = 0; l < patch_batch_size; ++l) a.v[l] += b.v[l];
+        return a;
+    }
+    friend ScalarLanes operator*(ScalarLanes a, const ScalarLanes& b) {
+        for (int l = 0; l < patch_batch_size; ++l) a.v[l] *= b.v[l];
+        return a;
+    }
+};
+
+#if defined(__AVX2__)
+struct SimdLanes {
+    __m256 v;
+
+    static SimdLanes Load(const float* p) { return {_mm256_loadu_ps(p)}; }
+    void Store(float* p) const { _mm256_storeu_ps(p, v); }
+    static SimdLanes Set(float s) { return {_mm256_set1_ps(s)}; }
+    friend SimdLanes operator+(const SimdLanes& a, const SimdLanes& b) { return {_mm256_add_ps(a.v, b.v)}; }
+    friend SimdLanes operator*(const SimdLanes& a, const SimdLanes& b) { return {_mm256_mul_ps(a.v, b.v)}; }
+};
+#elif defined(__SSE2__)
+struct SimdLanes {
+    __m128 lo, hi;
+
+    static SimdLanes Load(const float* p) { return {_mm_loadu_ps(p), _mm_loadu_ps(p + 4)}; }
+    void Store(float* p) const {
+        _mm_storeu_ps(p, lo);
+        _mm_storeu_ps(p + 4, hi);
+    }
+    static SimdLanes Set(float s) { return {_mm_set1_ps(s), _mm_set1_ps(s)}; }
+    friend SimdLanes operator+(const SimdLanes& a, const SimdLanes& b) {
+        return {_mm_add_ps(a.lo, b.lo), _mm_add_ps(a.hi, b.hi)};
+    }
+    friend SimdLanes operator*(const SimdLanes& a, const SimdLanes& b) {
+        return {_mm_mul_ps(a.lo, b.lo), _mm_mul_ps(a.hi, b.hi)};
+    }
+};
+#else
+using SimdLanes = ScalarLanes;
+#endif
+
+// Splits the curve with control points p[0], p[stride], p[2 * stride], p[3 * stride] into 5 points q[0],
+// q[stride], ..., q[4 * stride].
+template<typename Lanes>
+void SplitCurve(const Lanes p[], Lanes q[], int stride) {
+    const Lanes half{Lanes::Set(0.5f)};
+    const Lanes eighth{Lanes::Set(0.125f)};
+    const Lanes six{Lanes::Set(6.0f)};
+
+    q[0]          = (p[0] + p[stride]) * half;
+    q[stride]     = (p[0] + p[stride] * six + p[2 * stride]) * eighth;
+    q[2 * stride] = (p[stride] + p[2 * stride]) * half;
+    q[3 * stride] = (p[stride] + p[2 * stride] * six + p[3 * stride]) * eighth;
+    q[4 * stride] = (p[2 * stride] + p[3 * stride]) * half;
+}
+
+template<typename Lanes>
+void SubdividePatches(const PatchBatch& patches, SubpatchBatch& subpatches) {
+    for (int c = 0; c < 3; ++c) {
+        Lanes control[16];
+        for (int i = 0; i < 16; ++i) {
+            control[i] = Lanes::Load(patches.points[i][c]);
+        }
+
+        // Split each row of 4 points into 5, then each column of 4 of those into 5.
+        Lanes rows[4 * 5];
+        for (int row = 0; row < 4; ++row) {
+            SplitCurve(control + row * 4, rows + row * 5, 1);
+        }
+
+        Lanes subdivided[25];
+        for (int col = 0; col < 5; ++col) {
+            SplitCurve(rows + col, subdivided + col, 5);
+        }
+
+        for (int i = 0; i < 25; ++i) {
+            subdivided[i].Store(subpatches.points[i][c]);
+        }
+    }
+}
+
+template<typename Lanes>
+void ApplyStencils(const StencilTable& stencils, int begin, int end, int first_point,
+                   std::vector<InstanceBatchPoint>& points) {
+    const Lanes zero{Lanes::Set(0.0f)};
+    for (int i = begin; i < end; ++i) {
+        Lanes point[3] = {zero, zero, zero};
+        for (int j = stencils.offsets[i]; j < stencils.offsets[i + 1]; ++j) {
+            const Lanes weight{Lanes::Set(stencils.weights[j])};
+            const InstanceBatchPoint& source = points[stencils.indices[j]];
+            for (int c = 0; c < 3; ++c) {
+                point[c] = point[c] + weight * Lanes::Load(source.coords[c]);
+            }
+        }
+
+        for (int c = 0; c < 3; ++c) {
+            point[c].Store(points[first_point + i].coords[c]);
+        }
+    }
+}
+
+} // End anonymous namespace
+
+void SubdividePatchBatch(const PatchBatch& patches, SubpatchBatch& subpatches) {
+    SubdividePatches<SimdLanes>(patches, subpatches);
+}
+
+void SubdividePatchBatchScalar(const PatchBatch& patches, SubpatchBatch& subpatches) {
+    SubdividePatches<ScalarLanes>(patches, subpatches);
+}
+
+void ApplyStencilBatch(const StencilTable& stencils, int begin, int end, int first_point,
+                       std::vector<InstanceBatchPoint>& points) {
+    ApplyStencils<SimdLanes>(stencils, begin, end, first_point, points);
+}
+
+const char* PatchKernelInstructionSet() {
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+} // End namespace Subdivision
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+
+#include "subdivision/Stencil.h"
+
+namespace Subdivision {
+
+// The number of patches SubdividePatchBatch works on at once, one per SIMD lane.
+constexpr int patch_batch_size = 8;
+
+// The 4x4 control points of a batch of B-spline patches, in structure of arrays layout: coordinate c of control point
+// i of the patch in lane l is stored at points[i][c][l]. Control points are numbered row by row. Batches don't need
+// any particular alignment, since C++14 containers can't promise more than 16 bytes.
+struct PatchBatch {
+    float points[16][3][patch_batch_size];
+};
+
+// The 5x5 control points of the four subpatches of each patch in a PatchBatch, in the same layout.
+struct SubpatchBatch {
+    float points[25][3][patch_batch_size];
+};
+
+// Splits every patch in the batch at its parametric midpoint. Splitting a uniform cubic B-spline curve maps its 4
+// control points to 5 with the mask
+//     (p0 + p1) / 2, (p0 + 6p1 + p2) / 8, (p1 + p2) / 2, (p1 + 6p2 + p3) / 8, (p2 + p3) / 2,
+// and the patch is a tensor product of two curves, so the mask is applied to the rows and then to the columns.
+// Uses AVX2 or SSE2 when the build enables them. Every instruction set produces the same bits.
+void SubdividePatchBatch(const PatchBatch& patches, SubpatchBatch& subpatches);
+
+// The same split without SIMD, for checking and benchmarking the vectorized kernel.
+void SubdividePatchBatchScalar(const PatchBatch& patches, SubpatchBatch& subpatches);
+
+// One point of a batch of instances of a mesh, one instance per SIMD lane, in the same layout as PatchBatch:
+// coordinate c of the point in instance l is stored at coords[c][l].
+struct InstanceBatchPoint {
+    float coords[3][patch_batch_size];
+};
+
+// Computes stencils [begin, end) of stencils for every instance of a batch, into points[first_point + i] for stencil
+// i. Each stencil indexes earlier points of the batch. Each weight is loaded once for the whole batch, and the sums
+// are taken in the same order as TopologyRefiner::Refine(), so every lane gets the same bits as refining its instance
+// alone. Uses AVX2 or SSE2 like SubdividePatchBatch.
+void ApplyStencilBatch(const StencilTable& stencils, int begin, int end, int first_point,
+                       std::vector<InstanceBatchPoint>& points);
+
+// The instruction set SubdividePatchBatch and ApplyStencilBatch were compiled for: "AVX2", "SSE2" or "scalar".
+const char* PatchKernelInstructionSet();
+
+} // End namespace Subdivision
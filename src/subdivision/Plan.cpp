@@ -0,0 +1,457 @@
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+#include "subdivision/Plan.h"
+#include "subdivision/ObjMesh.h"
+#include "subdivision/Parallel.h"
+#include "subdivision/Subdivision.h"
+
+namespace Subdivision {
+
+namespace {
+
+// A plan while it is being built. The patch points index points, which holds vertex buffer indices.
+struct PlanQuadtree {
+    std::vector<PlanNode> nodes;
+    std::vector<int> patch_points;
+    std::vector<int> points;
+    std::unordered_map<int, int> point_indices;
+};
+
+// A face after the last level, turned by rotation quarter turns into the domain of its plan.
+PlanPatch RotatedPatch(const FaceData& face, int rotation) {
+    PlanPatch patch{face.depth, face.domain_row, face.domain_col, face.control_points};
+    for (int turn = 0; turn < rotation; ++turn) {
+        std::tie(patch.row, patch.col) = std::make_tuple((1 << patch.depth) - 1 - patch.col, patch.row);
+    }
+    RotateControlPoints(patch.control_points, (4 - rotation) % 4);
+
+    return patch;
+}
+
+// Whether the patch lies inside the square of the domain at the given depth, row and column.
+bool InsideSquare(const PlanPatch& patch, int depth, int row, int col) {
+    const int levels_below = patch.depth - depth;
+    return levels_below >= 0 && (patch.row >> levels_below) == row && (patch.col >> levels_below) == col;
+}
+
+// Fills in the node covering the given square, and adds all the nodes below it.
+void AddPlanNode(PlanQuadtree& quadtree, int node, int depth, int row, int col, const std::vector<PlanPatch>& patches) {
+    const PlanPatch* leaf_patch = nullptr;
+    bool split = false;
+    for (const auto& patch : patches) {
+        if (InsideSquare(patch, depth, row, col)) {
+            if (patch.depth == depth) {
+                leaf_patch = &patch;
+            } else {
+                split = true;
+            }
+        }
+    }
+
+    if (leaf_patch != nullptr && !split) {
+        quadtree.nodes[node] = {static_cast<int>(quadtree.patch_points.size()), true};
+        for (const auto& point : leaf_patch->control_points) {
+            if (point == -1) {
+                throw std::runtime_error("Patch of a subdivision plan is missing control points.");
+            }
+
+            const auto point_insert = quadtree.point_indices.emplace(point, quadtree.points.size());
+            if (point_insert.second) {
+                quadtree.points.push_back(point);
+            }
+            quadtree.patch_points.push_back(point_insert.first->second);
+        }
+    } else if (leaf_patch == nullptr && split) {
+        // The four children are added together, so the node only needs the first of them.
+        const int first_child = quadtree.nodes.size();
+        quadtree.nodes[node] = {first_child, false};
+        quadtree.nodes.resize(first_child + 4);
+
+        for (int quadrant = 0; quadrant < 4; ++quadrant) {
+            int row_offset, col_offset;
+            std::tie(row_offset, col_offset) = SubpatchOffset(quadrant);
+            AddPlanNode(quadtree, first_child + quadrant, depth + 1, row * 2 + row_offset, col * 2 + col_offset,
+                        patches);
+        }
+    } else {
+        throw std::runtime_error("The faces of a patch face do not cover its domain exactly once.");
+    }
+}
+
+// Hashes the keys of LocalTopology.
+struct TopologyKeyHash {
+    std::size_t operator()(const std::vector<int>& key) const noexcept {
+        std::size_t hash = key.size();
+        for (const auto& value : key) {
+            hash ^= std::hash<int>{}(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        }
+        return hash;
+    }
+};
+
+// The uniform cubic B-spline basis functions at t, and their derivatives.
+std::array<float, 4> BSplineBasis(float t) {
+    const float s = 1.0f - t;
+    return {{s * s * s / 6.0f,
+             (3.0f * t * t * t - 6.0f * t * t + 4.0f) / 6.0f,
+             (-3.0f * t * t * t + 3.0f * t * t + 3.0f * t + 1.0f) / 6.0f,
+             t * t * t / 6.0f}};
+}
+
+std::array<float, 4> BSplineDerivative(float t) {
+    const float s = 1.0f - t;
+    return {{-0.5f * s * s,
+             1.5f * t * t - 2.0f * t,
+             -1.5f * t * t + t + 0.5f,
+             0.5f * t * t}};
+}
+
+} // End anonymous namespace
+
+PlanTable CompileSubdivisionPlans(const TinyObjMesh& obj, int num_threads, const RefinementOptions& options) {
+    // The plans are recorded with stencils, so the positions of the control vertices don't matter.
+    const int num_control_vertices = obj.attrs.vertices.size() / 3;
+    std::vector<Stencil> stencil_buffer;
+    for (int i = 0; i < num_control_vertices; ++i) {
+        stencil_buffer.emplace_back(i);
+    }
+
+    // The control mesh is kept to find the topology around each patch face. SubdivideFaces() checks it is manifold.
+    RefinementArenas arenas;
+    std::vector<FaceDataPtr> face_data{GenerateFaceConnectivity(obj.meshes, num_threads)};
+    HalfEdgeMesh mesh{GenerateHalfEdgeMesh(face_data, num_control_vertices, EdgePairing::RadixSort, num_threads)};
+    GenerateVertexValences(mesh, num_threads);
+    const int num_patch_faces = NumberPatchFaces(face_data);
+
+    SubdivideFaces(face_data, stencil_buffer, options, num_threads, {}, &arenas);
+
+    // Every face left is a quad with a full grid of control points, and covers part of one patch face.
+    std::vector<std::vector<const FaceData*>> patch_faces(num_patch_faces);
+    for (const auto& face : face_data) {
+        patch_faces[face->patch_face].push_back(face.get());
+    }
+
+    // The topology around each patch face, walked from the corner which gives the smallest key. A quad can start from
+    // any of its corners, while a corner of another polygon has to start from that corner.
+    std::vector<LocalTopology> topologies(num_patch_faces);
+    std::vector<int> rotations(num_patch_faces, 0);
+    ParallelFor(0, mesh.NumFaces(), num_threads, [&](int faces_begin, int faces_end) {
+        int patch_face = 0;
+        for (int f = 0; f < faces_begin; ++f) {
+            patch_face += (mesh.FaceSize(f) == 4) ? 1 : mesh.FaceSize(f);
+        }
+
+        for (int f = faces_begin; f < faces_end; ++f) {
+            if (mesh.FaceSize(f) == 4) {
+                topologies[patch_face] = PatchFaceTopology(mesh, mesh.face_begin[f]);
+                for (int rotation = 1; rotation < 4; ++rotation) {
+                    LocalTopology rotated{PatchFaceTopology(mesh, mesh.face_begin[f] + rotation)};
+                    if (rotated.key < topologies[patch_face].key) {
+                        topologies[patch_face] = std::move(rotated);
+                        rotations[patch_face] = rotation;
+                    }
+                }
+                ++patch_face;
+            } else {
+                for (int corner = 0; corner < mesh.FaceSize(f); ++corner) {
+                    topologies[patch_face++] = PatchFaceTopology(mesh, mesh.face_begin[f] + corner);
+                }
+            }
+        }
+    });
+
+    // Patch faces with the same topology can still be refined to different depths, as each region of irregular faces
+    // goes as deep as the deepest face in it. So the squares their faces cover in the domain of the plan go in front of
+    // the key, led by their number, and only patch faces whose quadtrees have the same shape share a plan.
+    ParallelFor(0, num_patch_faces, num_threads, [&](int faces_begin, int faces_end) {
+        for (int p = faces_begin; p < faces_end; ++p) {
+            std::vector<std::array<int, 3>> squares;
+            for (const auto& face : patch_faces[p]) {
+                const PlanPatch patch{RotatedPatch(*face, rotations[p])};
+                squares.push_back({{patch.depth, patch.row, patch.col}});
+            }
+            std::sort(squares.begin(), squares.end());
+
+            std::vector<int> key{static_cast<int>(squares.size())};
+            for (const auto& square : squares) {
+                key.insert(key.end(), square.cbegin(), square.cend());
+            }
+            topologies[p].key.insert(topologies[p].key.begin(), key.cbegin(), key.cend());
+        }
+    });
+
+    // Patch faces with the same topology share the plan of the first of them, which is the only one compiled. If that
+    // plan reads control vertices beyond the walk around its face, the topology can't be trusted to decide the plan,
+    // so every patch face with it gets a plan of its own instead.
+    std::vector<int> first_faces(num_patch_faces);
+    std::unordered_map<std::vector<int>, int, TopologyKeyHash> topology_faces;
+    for (int p = 0; p < num_patch_faces; ++p) {
+        first_faces[p] = topology_faces.emplace(topologies[p].key, p).first->second;
+    }
+
+    std::vector<SubdivisionPlan> face_plans(num_patch_faces);
+    std::vector<char> shareable(num_patch_faces, false);
+    ParallelFor(0, num_patch_faces, num_threads, [&](int faces_begin, int faces_end) {
+        for (int p = faces_begin; p < faces_end; ++p) {
+            if (first_faces[p] == p) {
+                const std::size_t ring_size = topologies[p].ring.size();
+                face_plans[p] = CompileSubdivisionPlan(patch_faces[p], rotations[p], stencil_buffer,
+                                                       topologies[p].ring);
+                shareable[p] = topologies[p].ring.size() == ring_size;
+            }
+        }
+    });
+
+    PlanTable table;
+    table.face_rotations = rotations;
+    table.ring_offsets.push_back(0);
+    for (int p = 0; p < num_patch_faces; ++p) {
+        const int first_face = first_faces[p];
+        if (first_face != p && shareable[first_face]) {
+            table.face_plans.push_back(table.face_plans[first_face]);
+        } else {
+            if (first_face != p) {
+                face_plans[p] = CompileSubdivisionPlan(patch_faces[p], rotations[p], stencil_buffer,
+                                                       topologies[p].ring);
+            }
+
+            table.face_plans.push_back(table.plans.size());
+            table.plans.push_back(std::move(face_plans[p]));
+        }
+
+        table.rings.insert(table.rings.end(), topologies[p].ring.cbegin(), topologies[p].ring.cend());
+        table.ring_offsets.push_back(table.rings.size());
+    }
+
+    return table;
+}
+
+PackedPlanTable PackPlanTable(const PlanTable& table) {
+    // Where each plan starts in the nodes and stencil_offsets sections, and in the weights.
+    std::vector<int> node_bases{0}, stencil_bases{0}, weight_bases{0};
+    for (const auto& plan : table.plans) {
+        node_bases.push_back(node_bases.back() + plan.nodes.size());
+        stencil_bases.push_back(stencil_bases.back() + plan.stencils.NumStencils());
+        weight_bases.push_back(weight_bases.back() + plan.stencils.weights.size());
+    }
+
+    PackedPlanTable packed;
+    packed.num_patch_faces = table.NumPatchFaces();
+    auto& data = packed.data;
+
+    packed.nodes = data.size();
+    int patch_points_base = 0;
+    for (std::size_t p = 0; p < table.plans.size(); ++p) {
+        // The children of a node come after it, so the depths can be filled in as the nodes are packed.
+        const SubdivisionPlan& plan = table.plans[p];
+        std::vector<int> depths(plan.nodes.size(), 0);
+        for (std::size_t n = 0; n < plan.nodes.size(); ++n) {
+            const PlanNode& node = plan.nodes[n];
+            if (node.leaf) {
+                data.push_back(((patch_points_base + node.first) << 1) | 1);
+                packed.max_depth = std::max(packed.max_depth, depths[n]);
+            } else {
+                data.push_back((node_bases[p] + node.first) << 1);
+                std::fill_n(depths.begin() + node.first, 4, depths[n] + 1);
+            }
+        }
+        patch_points_base += plan.patch_points.size();
+    }
+
+    packed.faces = data.size();
+    for (int f = 0; f < table.NumPatchFaces(); ++f) {
+        data.push_back(node_bases[table.face_plans[f]]);
+        data.push_back(table.face_rotations[f]);
+        data.push_back(packed.num_points);
+        packed.num_points += table.plans[table.face_plans[f]].stencils.NumStencils();
+    }
+
+    packed.patch_points = data.size();
+    for (const auto& plan : table.plans) {
+        data.insert(data.end(), plan.patch_points.cbegin(), plan.patch_points.cend());
+    }
+
+    packed.points = data.size();
+    for (int f = 0; f < table.NumPatchFaces(); ++f) {
+        const int plan = table.face_plans[f];
+        for (int stencil = stencil_bases[plan]; stencil < stencil_bases[plan + 1]; ++stencil) {
+            data.push_back(table.ring_offsets[f]);
+            data.push_back(stencil);
+        }
+    }
+
+    packed.stencil_offsets = data.size();
+    for (std::size_t p = 0; p < table.plans.size(); ++p) {
+        const auto& offsets = table.plans[p].stencils.offsets;
+        for (auto offset = offsets.cbegin(); offset + 1 != offsets.cend(); ++offset) {
+            data.push_back(*offset + weight_bases[p]);
+        }
+    }
+    data.push_back(weight_bases.back());
+
+    packed.stencil_indices = data.size();
+    for (const auto& plan : table.plans) {
+        data.insert(data.end(), plan.stencils.indices.cbegin(), plan.stencils.indices.cend());
+        packed.weights.insert(packed.weights.end(), plan.stencils.weights.cbegin(), plan.stencils.weights.cend());
+    }
+
+    packed.rings = data.size();
+    data.insert(data.end(), table.rings.cbegin(), table.rings.cend());
+
+    return packed;
+}
+
+LocalTopology PatchFaceTopology(const HalfEdgeMesh& mesh, int start) {
+    LocalTopology topology;
+    auto add_face = [&mesh, &topology](int h) {
+        topology.key.push_back(mesh.FaceSize(mesh.face[h]));
+        for (int i = 0; i < mesh.FaceSize(mesh.face[h]); ++i, h = mesh.next[h]) {
+            if (std::find(topology.ring.cbegin(), topology.ring.cend(), mesh.vertex[h]) == topology.ring.cend()) {
+                topology.ring.push_back(mesh.vertex[h]);
+            }
+        }
+    };
+
+    add_face(start);
+
+    int h = start;
+    for (int i = 0; i < mesh.FaceSize(mesh.face[start]); ++i, h = mesh.next[h]) {
+        // Counterclockwise around the vertex, and then clockwise from the face if that stopped at the boundary.
+        topology.key.push_back(mesh.vertex_valence[mesh.vertex[h]]);
+        int around = mesh.NextAroundVertex(h);
+        for (; around != -1 && around != h; around = mesh.NextAroundVertex(around)) {
+            add_face(around);
+        }
+
+        if (around == -1) {
+            topology.key.push_back(-1);
+            for (around = h; mesh.twin[around] != -1; ) {
+                around = mesh.next[mesh.twin[around]];
+                add_face(around);
+            }
+        }
+    }
+
+    // The plan of a quad only depends on the faces around it. The corners of other polygons are capped from the
+    // refined mesh around them, which also depends on whether the faces next to the ring are refined, and so on the
+    // valences of the ring.
+    if (mesh.FaceSize(mesh.face[start]) != 4) {
+        for (const auto& vertex : topology.ring) {
+            topology.key.push_back(mesh.vertex_valence[vertex]);
+            topology.key.push_back(mesh.OnBoundary(vertex));
+        }
+    }
+
+    return topology;
+}
+
+SubdivisionPlan CompileSubdivisionPlan(const std::vector<const FaceData*>& faces, int rotation,
+                                       const std::vector<Stencil>& stencil_buffer, std::vector<int>& ring) {
+    // Turn the faces into the domain of the plan.
+    std::vector<PlanPatch> patches;
+    for (const auto& face : faces) {
+        patches.push_back(RotatedPatch(*face, rotation));
+    }
+
+    PlanQuadtree quadtree;
+    quadtree.nodes.resize(1);
+    AddPlanNode(quadtree, 0, 0, 0, 0, patches);
+
+    // Renumber the stencils to index the ring, keeping each one sorted.
+    std::vector<Stencil> stencils;
+    stencils.reserve(quadtree.points.size());
+    for (const auto& point : quadtree.points) {
+        const Stencil& stencil = stencil_buffer[point];
+        std::vector<std::pair<int, float>> weights;
+        for (int i = 0; i < stencil.Size(); ++i) {
+            auto slot = std::find(ring.cbegin(), ring.cend(), stencil.indices[i]);
+            if (slot == ring.cend()) {
+                ring.push_back(stencil.indices[i]);
+                slot = ring.cend() - 1;
+            }
+            weights.emplace_back(slot - ring.cbegin(), stencil.weights[i]);
+        }
+        std::sort(weights.begin(), weights.end());
+
+        stencils.emplace_back();
+        for (const auto& weight : weights) {
+            stencils.back().indices.push_back(weight.first);
+            stencils.back().weights.push_back(weight.second);
+        }
+    }
+
+    SubdivisionPlan plan;
+    plan.nodes = std::move(quadtree.nodes);
+    plan.patch_points = std::move(quadtree.patch_points);
+    plan.stencils = StencilTable{stencils, static_cast<int>(ring.size())};
+
+    return plan;
+}
+
+LimitPoint EvaluateLimit(const PlanTable& table,
+                         const std::vector<glm::vec3>& control_vertices,
+                         int patch_face, float u, float v) {
+    const SubdivisionPlan& plan = table.plans[table.face_plans[patch_face]];
+    const int* ring = &table.rings[table.ring_offsets[patch_face]];
+    u = glm::clamp(u, 0.0f, 1.0f);
+    v = glm::clamp(v, 0.0f, 1.0f);
+    RotateDomain(u, v, table.face_rotations[patch_face]);
+
+    // Walk down to the patch containing (u, v), moving (u, v) into the domain of each child on the way.
+    int node = 0;
+    while (!plan.nodes[node].leaf) {
+        const int row_offset = (u >= 0.5f) ? 1 : 0;
+        const int col_offset = (v >= 0.5f) ? 1 : 0;
+        u = u * 2.0f - row_offset;
+        v = v * 2.0f - col_offset;
+
+        // The inverse of SubpatchOffset().
+        const int quadrant = (row_offset == 0) ? col_offset : 3 - col_offset;
+        node = plan.nodes[node].first + quadrant;
+    }
+
+    std::array<glm::vec3, 16> points;
+    for (int i = 0; i < 16; ++i) {
+        const int stencil = plan.patch_points[plan.nodes[node].first + i];
+        glm::vec3 point{0.0f};
+        for (int j = plan.stencils.offsets[stencil]; j < plan.stencils.offsets[stencil + 1]; ++j) {
+            point += plan.stencils.weights[j] * control_vertices[ring[plan.stencils.indices[j]]];
+        }
+
+        points[i] = point;
+    }
+
+    const auto basis_u = BSplineBasis(u);
+    const auto basis_v = BSplineBasis(v);
+    const auto derivative_u = BSplineDerivative(u);
+    const auto derivative_v = BSplineDerivative(v);
+
+    LimitPoint limit{glm::vec3{0.0f}, glm::vec3{0.0f}};
+    glm::vec3 tangent_u{0.0f}, tangent_v{0.0f};
+    for (int row = 0; row < 4; ++row) {
+        for (int col = 0; col < 4; ++col) {
+            const glm::vec3& point = points[row * 4 + col];
+            limit.position += basis_u[row] * basis_v[col] * point;
+            tangent_u += derivative_u[row] * basis_v[col] * point;
+            tangent_v += basis_u[row] * derivative_v[col] * point;
+        }
+    }
+
+    // As in the shader, dP/dv x dP/du points out of the counterclockwise faces of the control mesh.
+    limit.normal = glm::normalize(glm::cross(tangent_v, tangent_u));
+
+    return limit;
+}
+
+void RotateDomain(float& u, float& v, int quarter_turns) {
+    for (int turn = 0; turn < quarter_turns; ++turn) {
+        std::tie(u, v) = std::make_tuple(1.0f - v, u);
+    }
+}
+
+} // End namespace Subdivision
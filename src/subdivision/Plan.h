@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "subdivision/Connectivity.h"
+#include "subdivision/HalfEdge.h"
+#include "subdivision/Stencil.h"
+#include "subdivision/Subdivision.h"
+
+namespace Subdivision {
+
+struct TinyObjMesh;
+
+// A node of the quadtree of a subdivision plan. Leaves are B-spline patches. Other nodes are split into four children,
+// one per quadrant of their domain, in the order of the corners of a face: (row, col) offsets (0, 0), (0, 1), (1, 1)
+// and (1, 0).
+struct PlanNode {
+    // For leaves, the first of the 16 control points of the patch in patch_points. Otherwise the first of the four
+    // children in nodes.
+    int first;
+    bool leaf;
+};
+
+// How to evaluate the limit surface over a patch face of the control mesh, following Brainerd et al. 2016. The face's
+// domain is a quadtree of B-spline patches, down to the faces left after the last level of refinement, and the control
+// points of the patches are stencils over the control vertices around the face. A plan only depends on the
+// connectivity around the face and the depth it is refined to, so it stays valid as the control vertices move, and is
+// shared by every patch face with the same connectivity and quadtree.
+struct SubdivisionPlan {
+    // nodes[0] is the root, which covers the whole face.
+    std::vector<PlanNode> nodes;
+    // The 16 control points of each leaf, as indices into stencils.
+    std::vector<int> patch_points;
+    // The stencils index the control vertices of a patch face in the order of its ring in the PlanTable.
+    StencilTable stencils;
+
+    int NumPatches() const { return patch_points.size() / 16; }
+};
+
+// The plans of a mesh, with one entry per patch face, in the order given by NumberPatchFaces(): each quad, with the
+// corners of other polygons in place of the polygon.
+struct PlanTable {
+    std::vector<SubdivisionPlan> plans;
+
+    // The plan of each patch face, and the number of quarter turns from the face's domain to the plan's.
+    std::vector<int> face_plans;
+    std::vector<int> face_rotations;
+
+    // The control vertices of patch face f, in the order its plan indexes them, are in
+    // [ring_offsets[f], ring_offsets[f + 1]) of rings.
+    std::vector<int> ring_offsets;
+    std::vector<int> rings;
+
+    int NumPatchFaces() const { return face_plans.size(); }
+};
+
+// A PlanTable flattened for the GPU, which reads it from shader storage buffers. A compute shader evaluates the
+// stencils of every patch face into a buffer of points, and the tessellation evaluation shader walks the quadtrees
+// down to the 16 of those points it needs. Only the last member of a buffer block can be an unsized array, so the
+// integer data is one array split into sections, each starting at the offset named after it. Every index is into its
+// own section:
+//  - nodes: one per node, (first << 1) | leaf, where first is the first child node or the first patch point.
+//  - faces: three per patch face, the root node of its plan, its rotation, and its first point.
+//  - patch_points: the control points of each leaf, as stencils of its plan, so the point of patch face f with
+//    stencil s is point faces[3 * f + 2] + s.
+//  - points: two per point, the start of its patch face's ring in rings and its stencil.
+//  - stencil_offsets: the weights of stencil i are in [stencil_offsets[i], stencil_offsets[i + 1]).
+//  - stencil_indices: the slot in the patch face's ring of each weight.
+//  - rings: control vertex indices.
+struct PackedPlanTable {
+    std::vector<int> data;
+    std::vector<float> weights;
+
+    int nodes = 0;
+    int faces = 0;
+    int patch_points = 0;
+    int points = 0;
+    int stencil_offsets = 0;
+    int stencil_indices = 0;
+    int rings = 0;
+
+    int num_patch_faces = 0;
+    int num_points = 0;
+    // The depth of the deepest leaf.
+    int max_depth = 0;
+};
+
+PackedPlanTable PackPlanTable(const PlanTable& table);
+
+// The connectivity around a patch face, which decides whether two patch faces can share a plan.
+struct LocalTopology {
+    // The control vertices around the face, in the order they are reached from the half-edge the walk starts at.
+    std::vector<int> ring;
+    // The valence of each corner of the face, followed by the sizes of the faces around it in the order they are
+    // reached, with -1 wherever the walk around the corner hits the boundary. For corners of polygons other than quads,
+    // followed by the valence and boundary flag of each vertex of the ring. CompileSubdivisionPlans() puts the squares
+    // covered by the face's quadtree in front, since faces with the same connectivity can be refined to different
+    // depths.
+    std::vector<int> key;
+};
+
+struct LimitPoint {
+    glm::vec3 position;
+    glm::vec3 normal;
+};
+
+PlanTable CompileSubdivisionPlans(const TinyObjMesh& obj_data, int num_threads = 1,
+                                  const RefinementOptions& options = {});
+
+// Walks the faces around each vertex of the face of half-edge start, beginning with the vertex of start.
+LocalTopology PatchFaceTopology(const HalfEdgeMesh& mesh, int start);
+
+// The faces of one patch face after the last level, as they go into its plan.
+struct PlanPatch {
+    int depth;
+    int row;
+    int col;
+    std::array<int, 16> control_points;
+};
+
+// Builds the plan of one patch face from its faces after the last level, whose control points index stencil_buffer.
+// The faces are turned by rotation quarter turns first, and the stencils are renumbered to index ring, which gains any
+// control vertex the stencils read which it is missing.
+SubdivisionPlan CompileSubdivisionPlan(const std::vector<const FaceData*>& faces, int rotation,
+                                       const std::vector<Stencil>& stencil_buffer, std::vector<int>& ring);
+
+// Evaluates the limit surface of a patch face at (u, v) in [0, 1]^2, by walking down its quadtree to the patch which
+// contains (u, v). As in the tessellation evaluation shader, u runs along the rows of the control points, from
+// vertices[0] of the patch face to vertices[3], and v along the columns, from vertices[0] to vertices[1]. A corner of
+// another polygon has the centre of the polygon at vertices[0] and the corner vertex at vertices[2].
+LimitPoint EvaluateLimit(const PlanTable& table,
+                         const std::vector<glm::vec3>& control_vertices,
+                         int patch_face, float u, float v);
+
+// Turns (u, v) by quarter turns, each of which moves vertices[1] of a quad to where vertices[0] was.
+void RotateDomain(float& u, float& v, int quarter_turns);
+
+} // End namespace Subdivision
@@ -0,0 +1,113 @@
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "subdivision/Stencil.h"
+
+namespace Subdivision {
+
+Stencil::Stencil(int control_vertex)
+        : indices{control_vertex}
+        , weights{1.0f} {}
+
+Stencil& Stencil::operator+=(const Stencil& rhs) {
+    // Both index lists are sorted, so the sum is a single merge pass.
+    std::vector<int> merged_indices;
+    std::vector<float> merged_weights;
+    merged_indices.reserve(indices.size() + rhs.indices.size());
+    merged_weights.reserve(indices.size() + rhs.indices.size());
+
+    std::size_t i = 0, j = 0;
+    while (i < indices.size() || j < rhs.indices.size()) {
+        if (j == rhs.indices.size() || (i < indices.size() && indices[i] < rhs.indices[j])) {
+            merged_indices.push_back(indices[i]);
+            merged_weights.push_back(weights[i]);
+            ++i;
+        } else if (i == indices.size() || rhs.indices[j] < indices[i]) {
+            merged_indices.push_back(rhs.indices[j]);
+            merged_weights.push_back(rhs.weights[j]);
+            ++j;
+        } else {
+            merged_indices.push_back(indices[i]);
+            merged_weights.push_back(weights[i] + rhs.weights[j]);
+            ++i;
+            ++j;
+        }
+    }
+
+    indices = std::move(merged_indices);
+    weights = std::move(merged_weights);
+
+    return *this;
+}
+
+Stencil& Stencil::operator*=(float scale) {
+    for (auto& weight : weights) {
+        weight *= scale;
+    }
+
+    return *this;
+}
+
+Stencil& Stencil::operator/=(float scale) {
+    for (auto& weight : weights) {
+        weight /= scale;
+    }
+
+    return *this;
+}
+
+Stencil operator+(Stencil lhs, const Stencil& rhs) {
+    return lhs += rhs;
+}
+
+Stencil operator*(Stencil lhs, float scale) {
+    return lhs *= scale;
+}
+
+Stencil operator*(float scale, Stencil rhs) {
+    return rhs *= scale;
+}
+
+Stencil operator/(Stencil lhs, float scale) {
+    return lhs /= scale;
+}
+
+StencilTable::StencilTable(const std::vector<Stencil>& stencils, int num_controls)
+        : num_control_vertices(num_controls) {
+    offsets.reserve(stencils.size() + 1);
+    offsets.push_back(0);
+    for (const auto& stencil : stencils) {
+        indices.insert(indices.end(), stencil.indices.cbegin(), stencil.indices.cend());
+        weights.insert(weights.end(), stencil.weights.cbegin(), stencil.weights.cend());
+        offsets.push_back(indices.size());
+    }
+}
+
+StencilMesh::StencilMesh(const StencilTable& table, const std::vector<int>& indexes)
+        : stencils(table)
+        , indices(indexes) {}
+
+void ApplyStencilTable(const StencilTable& table,
+                       const std::vector<glm::vec3>& control_vertices,
+                       std::vector<glm::vec3>& refined_vertices) {
+    if (static_cast<int>(control_vertices.size()) != table.num_control_vertices) {
+        throw std::runtime_error("Stencil table expects " + std::to_string(table.num_control_vertices) +
+                                 " control vertices, but " + std::to_string(control_vertices.size()) +
+                                 " were given.");
+    }
+
+    // Only allocates the first time a buffer is used with this table.
+    refined_vertices.resize(table.NumStencils());
+
+    for (int i = 0; i < table.NumStencils(); ++i) {
+        glm::vec3 refined_vertex(0.0f);
+        for (int j = table.offsets[i]; j < table.offsets[i + 1]; ++j) {
+            refined_vertex += table.weights[j] * control_vertices[table.indices[j]];
+        }
+
+        refined_vertices[i] = refined_vertex;
+    }
+}
+
+} // End namespace Subdivision
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace Subdivision {
+
+// A refined point expressed as a weighted sum of control vertices. Used in place of glm::vec3 as the vertex type
+// when recording a subdivision, so every point the refinement generates captures its weights instead of a position.
+struct Stencil {
+    // Sorted by control vertex index, with one weight per index.
+    std::vector<int> indices;
+    std::vector<float> weights;
+
+    Stencil() = default;
+    explicit Stencil(int control_vertex);
+
+    int Size() const { return indices.size(); }
+
+    Stencil& operator+=(const Stencil& rhs);
+    Stencil& operator*=(float scale);
+    Stencil& operator/=(float scale);
+};
+
+Stencil operator+(Stencil lhs, const Stencil& rhs);
+Stencil operator*(Stencil lhs, float scale);
+Stencil operator*(float scale, Stencil rhs);
+Stencil operator/(Stencil lhs, float scale);
+
+// The stencils of every point in a refined vertex buffer, flattened into CSR layout. The weights of output point i
+// are stored in [offsets[i], offsets[i + 1]) of indices and weights.
+struct StencilTable {
+    int num_control_vertices;
+    std::vector<int> offsets;
+    std::vector<int> indices;
+    std::vector<float> weights;
+
+    // An empty table, with no stencils.
+    StencilTable() : num_control_vertices(0), offsets(1, 0) {}
+    StencilTable(const std::vector<Stencil>& stencils, int num_controls);
+
+    int NumStencils() const { return offsets.size() - 1; }
+};
+
+struct StencilMesh {
+    StencilTable stencils;
+    std::vector<int> indices;
+
+    StencilMesh(const StencilTable& table, const std::vector<int>& indexes);
+};
+
+void ApplyStencilTable(const StencilTable& table,
+                       const std::vector<glm::vec3>& control_vertices,
+                       std::vector<glm::vec3>& refined_vertices);
+
+} // End namespace Subdivision
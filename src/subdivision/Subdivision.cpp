@@ -0,0 +1,1117 @@
+#include <algorithm>
+#include <utility>
+#include <cassert>
+#include <iostream>
+#include <cmath>
+
+#include <glm/gtc/constants.hpp>
+
+#include "subdivision/Subdivision.h"
+#include "subdivision/ObjMesh.h"
+#include "subdivision/Parallel.h"
+#include "subdivision/PatchKernel.h"
+
+namespace Subdivision {
+
+IndexedMesh SubdivideMesh(const TinyObjMesh& obj, int num_threads, const RefinementOptions& options) {
+    // Initialize vertex buffer.
+    std::vector<glm::vec3> vertex_buffer;
+    vertex_buffer.reserve(obj.attrs.vertices.size() / 3);
+    for (std::size_t i = 0; i < obj.attrs.vertices.size(); i += 3) {
+        vertex_buffer.emplace_back(obj.attrs.vertices[i], obj.attrs.vertices[i + 1], obj.attrs.vertices[i + 2]);
+    }
+
+    PatchTable patches{SubdividePatches(obj, vertex_buffer, num_threads, options)};
+    std::vector<PatchBounds> patch_bounds{ComputePatchBounds(vertex_buffer, patches.indices, num_threads)};
+
+    return {std::move(vertex_buffer), std::move(patches.indices), std::move(patch_bounds), std::move(patches.flags),
+            std::move(patches.levels)};
+}
+
+StencilMesh RecordStencilMesh(const TinyObjMesh& obj, int num_threads, const RefinementOptions& options) {
+    // Initialize the stencil buffer. Each control vertex is a stencil which selects only itself.
+    const int num_control_vertices = obj.attrs.vertices.size() / 3;
+    std::vector<Stencil> stencil_buffer;
+    stencil_buffer.reserve(num_control_vertices);
+    for (int i = 0; i < num_control_vertices; ++i) {
+        stencil_buffer.emplace_back(i);
+    }
+
+    const PatchTable patches{SubdividePatches(obj, stencil_buffer, num_threads, options)};
+
+    return {StencilTable{stencil_buffer, num_control_vertices}, patches.indices};
+}
+
+std::vector<PatchBounds> ComputePatchBounds(const std::vector<glm::vec3>& vertices, const std::vector<int>& indices,
+                                            int num_threads) {
+    std::vector<PatchBounds> patch_bounds(indices.size() / 16);
+
+    ParallelFor(0, patch_bounds.size(), num_threads, [&](int begin, int end) {
+        for (int patch = begin; patch < end; ++patch) {
+            const int* points = &indices[patch * 16];
+            PatchBounds& bounds = patch_bounds[patch];
+
+            bounds.box_min = bounds.box_max = vertices[points[0]];
+            for (int i = 1; i < 16; ++i) {
+                bounds.box_min = glm::min(bounds.box_min, vertices[points[i]]);
+                bounds.box_max = glm::max(bounds.box_max, vertices[points[i]]);
+            }
+
+            // The derivatives of the patch along u and v are positive combinations of the differences between
+            // neighbouring control points down the columns and along the rows, so the normal, cross(dP/dv, dP/du), is
+            // a positive combination of the cross products of those differences. A cone around the cross products
+            // holds every normal, as long as it is no wider than a half-space.
+            std::array<glm::vec3, 12> u_diffs, v_diffs;
+            for (int i = 0; i < 12; ++i) {
+                u_diffs[i] = vertices[points[i + 4]] - vertices[points[i]];
+                v_diffs[i] = vertices[points[i / 3 * 4 + i % 3 + 1]] - vertices[points[i / 3 * 4 + i % 3]];
+            }
+
+            std::array<glm::vec3, 144> normals;
+            int num_normals = 0;
+            glm::vec3 axis{0.0f};
+            for (const auto& v_diff : v_diffs) {
+                for (const auto& u_diff : u_diffs) {
+                    const glm::vec3 normal = glm::cross(v_diff, u_diff);
+                    const float length = glm::length(normal);
+                    if (length > 0.0f) {
+                        normals[num_normals] = normal / length;
+                        axis += normals[num_normals++];
+                    }
+                }
+            }
+
+            bounds.cone_axis = glm::vec3{0.0f};
+            bounds.cone_angle = glm::pi<float>();
+            if (glm::length(axis) == 0.0f) {
+                continue;
+            }
+
+            axis = glm::normalize(axis);
+            float min_cos = 1.0f;
+            for (int i = 0; i < num_normals; ++i) {
+                min_cos = std::min(min_cos, glm::dot(axis, normals[i]));
+            }
+
+            if (min_cos >= 0.0f) {
+                bounds.cone_axis = axis;
+                bounds.cone_angle = std::acos(std::min(min_cos, 1.0f));
+            }
+        }
+    });
+
+    return patch_bounds;
+}
+
+std::vector<float> CurvaturePriorities(const TinyObjMesh& obj, float full_angle) {
+    auto position = [&obj](int vertex) {
+        return glm::vec3{obj.attrs.vertices[3 * vertex], obj.attrs.vertices[3 * vertex + 1],
+                         obj.attrs.vertices[3 * vertex + 2]};
+    };
+
+    // Newell's normal of each face, whose length is the face's area, which weights the average normal at each vertex.
+    std::vector<glm::vec3> face_normals;
+    std::vector<glm::vec3> vertex_normals(obj.attrs.vertices.size() / 3, glm::vec3{0.0f});
+    for (const auto& mesh : obj.meshes) {
+        std::size_t offset = 0;
+        for (const int num_vertices : mesh.num_face_vertices) {
+            glm::vec3 normal{0.0f};
+            for (int v = 0; v < num_vertices; ++v) {
+                const glm::vec3 current = position(mesh.indices[offset + v].vertex_index);
+                const glm::vec3 next = position(mesh.indices[offset + (v + 1) % num_vertices].vertex_index);
+                normal += glm::cross(current, next);
+            }
+
+            face_normals.push_back(normal * 0.5f);
+            for (int v = 0; v < num_vertices; ++v) {
+                vertex_normals[mesh.indices[offset + v].vertex_index] += face_normals.back();
+            }
+            offset += num_vertices;
+        }
+    }
+
+    std::vector<float> priorities;
+    for (const auto& mesh : obj.meshes) {
+        std::size_t offset = 0;
+        for (const int num_vertices : mesh.num_face_vertices) {
+            const glm::vec3 face_normal = face_normals[priorities.size()];
+            float max_angle = 0.0f;
+            for (int v = 0; v < num_vertices; ++v) {
+                const glm::vec3 vertex_normal = vertex_normals[mesh.indices[offset + v].vertex_index];
+                const float lengths = glm::length(face_normal) * glm::length(vertex_normal);
+                if (lengths > 0.0f) {
+                    const float cos_angle = glm::dot(face_normal, vertex_normal) / lengths;
+                    max_angle = std::max(max_angle, std::acos(std::max(-1.0f, std::min(cos_angle, 1.0f))));
+                }
+            }
+
+            priorities.push_back(std::min(max_angle / full_angle, 1.0f));
+            offset += num_vertices;
+        }
+    }
+
+    return priorities;
+}
+
+template<typename Point>
+PatchTable SubdividePatches(const TinyObjMesh& obj, std::vector<Point>& vertex_buffer, int num_threads,
+                            const RefinementOptions& options, const StageCallback<Point>& end_stage) {
+    // Initialize faces. The arenas hold the faces the refinement creates, so they must outlive face_data.
+    RefinementArenas arenas;
+    std::vector<FaceDataPtr> face_data{GenerateFaceConnectivity(obj.meshes, num_threads)};
+
+    // Which patch faces lie on polygons other than quads, in the order NumberPatchFaces() gives them.
+    std::vector<bool> polygon_patch_faces;
+    for (const auto& face : face_data) {
+        const bool polygon = face->Valence() != 4;
+        polygon_patch_faces.insert(polygon_patch_faces.end(), polygon ? face->Valence() : 1, polygon);
+    }
+
+    SubdivideFaces(face_data, vertex_buffer, options, num_threads, end_stage, &arenas);
+
+    // Copy the patches out of the face data, which is freed on return. Every quad now has a full grid of control
+    // points: either it is regular, or it is an end cap.
+    const int num_patches = std::count_if(face_data.cbegin(), face_data.cend(),
+                                          [](const FaceDataPtr& face) { return face->Valence() == 4; });
+    PatchTable patches;
+    patches.indices.reserve(16 * num_patches);
+    patches.flags.reserve(num_patches);
+    patches.levels.reserve(num_patches);
+    for (const auto& face : face_data) {
+        if (face->Valence() == 4) {
+            patches.indices.insert(patches.indices.end(), face->control_points.cbegin(), face->control_points.cend());
+            patches.flags.push_back((face->regular ? 0 : patch_end_cap)
+                                    | (polygon_patch_faces[face->patch_face] ? patch_polygon : 0));
+            patches.levels.push_back(face->depth);
+        }
+    }
+
+    return patches;
+}
+
+template<typename Point>
+void SubdivideFaces(std::vector<FaceDataPtr>& face_data, std::vector<Point>& vertex_buffer,
+                    const RefinementOptions& options, int num_threads, const StageCallback<Point>& end_stage,
+                    RefinementArenas* arenas) {
+    NumberPatchFaces(face_data);
+    const int depth = SetMaxDepths(face_data, options);
+    const bool uniform_depth = std::all_of(face_data.cbegin(), face_data.cend(),
+                                           [depth](const FaceDataPtr& face) { return face->max_depth == depth; });
+
+    HalfEdgeMesh mesh{GenerateHalfEdgeMesh(face_data, vertex_buffer.size(), EdgePairing::RadixSort, num_threads)};
+    GenerateHalfEdgeVertexConnectivity(mesh, face_data, num_threads);
+    GenerateControlPoints(mesh, face_data, num_threads);
+    CompleteControlPoints(mesh, face_data, vertex_buffer);
+    if (end_stage) {
+        end_stage(vertex_buffer);
+    }
+
+    // Only the irregular region is refined, which still uses the pointer-based connectivity.
+    std::vector<EdgeData> edge_data{GenerateEdgeData(mesh, face_data)};
+    Arena* level_arena = (arenas != nullptr) ? &arenas->NextLevel() : nullptr;
+    std::vector<VertexData> vertex_data{GenerateIrregularVertexConnectivity(edge_data, 0, vertex_buffer.size(),
+                                                                            level_arena)};
+
+    for (int level = 0; level < depth; ++level) {
+        if (!uniform_depth) {
+            CapIsolatedRegions(vertex_data, level);
+        }
+        CreateNewFaces(vertex_buffer, face_data, edge_data, vertex_data, num_threads, arenas);
+        if (end_stage) {
+            end_stage(vertex_buffer);
+        }
+    }
+
+    AddEndCaps(face_data, vertex_buffer, num_threads);
+    if (end_stage) {
+        end_stage(vertex_buffer);
+    }
+}
+
+int SetMaxDepths(std::vector<FaceDataPtr>& face_data, const RefinementOptions& options) {
+    const auto& priorities = options.face_priorities;
+    if (!priorities.empty() && priorities.size() != face_data.size()) {
+        throw std::runtime_error("Got " + std::to_string(priorities.size()) + " face priorities for "
+                                 + std::to_string(face_data.size()) + " faces.");
+    }
+
+    int depth = 0;
+    for (std::size_t f = 0; f < face_data.size(); ++f) {
+        FaceData& face = *face_data[f];
+        face.max_depth = options.max_depth;
+        if (!priorities.empty()) {
+            const float priority = std::max(0.0f, std::min(priorities[f], 1.0f));
+            face.max_depth = std::ceil(priority * options.max_depth);
+        }
+        if (face.Valence() != 4) {
+            face.max_depth = std::max(face.max_depth, 1);
+        }
+
+        depth = std::max(depth, face.max_depth);
+    }
+
+    return depth;
+}
+
+void CapIsolatedRegions(std::vector<VertexData>& vertex_data, int level) {
+    // Number the irregular faces and join the ones around each vertex into regions.
+    std::unordered_map<FaceData*, int> face_indices;
+    std::vector<int> parents;
+    auto find_region = [&parents](int face) {
+        while (parents[face] != face) {
+            parents[face] = parents[parents[face]];
+            face = parents[face];
+        }
+        return face;
+    };
+
+    for (const auto& vertex : vertex_data) {
+        int region = -1;
+        for (const auto& face : vertex.adjacent_faces) {
+            if (!face->Refines()) {
+                continue;
+            }
+
+            auto face_index = face_indices.emplace(face, parents.size());
+            if (face_index.second) {
+                parents.push_back(face_index.first->second);
+            }
+
+            const int face_region = find_region(face_index.first->second);
+            if (region == -1) {
+                region = face_region;
+            } else if (face_region != region) {
+                parents[face_region] = region;
+            }
+        }
+    }
+
+    // Each region goes as deep as the deepest of its faces.
+    std::vector<int> region_depths(parents.size(), 0);
+    for (const auto& face_index : face_indices) {
+        int& region_depth = region_depths[find_region(face_index.second)];
+        region_depth = std::max(region_depth, face_index.first->max_depth);
+    }
+
+    for (auto& face_index : face_indices) {
+        if (region_depths[find_region(face_index.second)] <= level) {
+            face_index.first->end_cap = true;
+        }
+    }
+
+    // The faces around a vertex are all in one region, so a vertex next to an end cap has nothing left to refine.
+    std::vector<VertexData> refined_vertices;
+    for (auto& vertex : vertex_data) {
+        if (std::any_of(vertex.adjacent_faces.cbegin(), vertex.adjacent_faces.cend(),
+                        [](const FaceData* face) { return face->Refines(); })) {
+            refined_vertices.push_back(std::move(vertex));
+        }
+    }
+
+    vertex_data = std::move(refined_vertices);
+}
+
+int NumberPatchFaces(std::vector<FaceDataPtr>& face_data) {
+    int num_patch_faces = 0;
+    for (auto& face : face_data) {
+        face->patch_face = num_patch_faces;
+        num_patch_faces += (face->Valence() == 4) ? 1 : face->Valence();
+    }
+
+    return num_patch_faces;
+}
+
+int MissingPoints::Add(int from0, int from1, int from2) {
+    points.push_back({end, {{from0, from1, from2}}});
+    return end++;
+}
+
+template<typename Point>
+void CompleteControlPoints(const HalfEdgeMesh& mesh, std::vector<FaceDataPtr>& face_data,
+                           std::vector<Point>& vertex_buffer) {
+    MissingPoints missing_points{static_cast<int>(vertex_buffer.size())};
+    AddPhantomControlPoints(mesh, face_data, missing_points);
+
+    // Irregular faces are split into subpatches, so fill in the rest of their grids as well.
+    for (auto& face : face_data) {
+        if (!face->regular && face->Valence() == 4) {
+            FillMissingControlPoints(*face, missing_points);
+        }
+    }
+
+    AddMissingPoints(missing_points, vertex_buffer);
+}
+
+template<typename Point>
+void AddMissingPoints(const MissingPoints& missing_points, std::vector<Point>& vertex_buffer) {
+    vertex_buffer.resize(missing_points.end);
+    for (const auto& missing : missing_points.points) {
+        const auto& from = missing.from;
+        assert(from[0] < missing.point && from[1] < missing.point && from[2] < missing.point);
+        if (from[2] == -1) {
+            vertex_buffer[missing.point] = vertex_buffer[from[0]] * 2.0f + vertex_buffer[from[1]] * -1.0f;
+        } else {
+            vertex_buffer[missing.point] = vertex_buffer[from[0]] + vertex_buffer[from[1]]
+                                           + vertex_buffer[from[2]] * -1.0f;
+        }
+    }
+}
+
+void AddPhantomControlPoints(const HalfEdgeMesh& mesh, std::vector<FaceDataPtr>& face_data,
+                             MissingPoints& missing_points) {
+    for (int f = 0; f < mesh.NumFaces(); ++f) {
+        FaceData& face = *face_data[f];
+        if (face.Valence() != 4) {
+            continue;
+        }
+
+        auto boundary_edge = [&mesh, f](int edge) { return mesh.twin[mesh.face_begin[f] + edge] == -1; };
+
+        // Mirrors the point inner1 across the boundary, away from inner2.
+        auto extrapolate = [&face, &missing_points](int point, int inner1, int inner2) {
+            auto& control_points = face.control_points;
+            if (control_points[point] != -1 || control_points[inner1] == -1 || control_points[inner2] == -1) {
+                return;
+            }
+
+            control_points[point] = missing_points.Add(control_points[inner1], control_points[inner2]);
+        };
+
+        // The rows across edges 0 and 2 first, then the columns across edges 3 and 1. Corners of the grid are filled
+        // by the second pass, from the phantom points of the first.
+        for (int col = 0; col < 4; ++col) {
+            if (boundary_edge(0)) {
+                extrapolate(col, 4 + col, 8 + col);
+            }
+            if (boundary_edge(2)) {
+                extrapolate(12 + col, 8 + col, 4 + col);
+            }
+        }
+
+        for (int row = 0; row < 4; ++row) {
+            if (boundary_edge(3)) {
+                extrapolate(row * 4, row * 4 + 1, row * 4 + 2);
+            }
+            if (boundary_edge(1)) {
+                extrapolate(row * 4 + 3, row * 4 + 2, row * 4 + 1);
+            }
+        }
+    }
+}
+
+void FillMissingControlPoints(FaceData& face, MissingPoints& missing_points) {
+    auto& control_points = face.control_points;
+
+    // The four inner points are the face's own vertices, so the sides of the grid can always be mirrored from them.
+    for (int i = 1; i < 3; ++i) {
+        const std::array<std::array<int, 3>, 4> sides{{{{i, 4 + i, 8 + i}},
+                                                       {{12 + i, 8 + i, 4 + i}},
+                                                       {{i * 4, i * 4 + 1, i * 4 + 2}},
+                                                       {{i * 4 + 3, i * 4 + 2, i * 4 + 1}}}};
+        for (const auto& side : sides) {
+            if (control_points[side[0]] == -1) {
+                control_points[side[0]] = missing_points.Add(control_points[side[1]], control_points[side[2]]);
+            }
+        }
+    }
+
+    // Each corner of the grid, its two neighbours on the sides, and the inner point diagonally across from it.
+    const std::array<std::array<int, 4>, 4> corners{{{{0, 1, 4, 5}},
+                                                     {{3, 2, 7, 6}},
+                                                     {{12, 8, 13, 9}},
+                                                     {{15, 11, 14, 10}}}};
+    for (const auto& corner : corners) {
+        if (control_points[corner[0]] == -1) {
+            control_points[corner[0]] = missing_points.Add(control_points[corner[1]], control_points[corner[2]],
+                                                           control_points[corner[3]]);
+        }
+    }
+}
+
+template<typename Point>
+void AddEndCaps(std::vector<FaceDataPtr>& face_data, std::vector<Point>& vertex_buffer, int num_threads) {
+    // Faces split from a quad already have the subpatch of their parent as control points, which lines up with the
+    // subpatches of their neighbours from the same parent.
+    MissingPoints missing_points{static_cast<int>(vertex_buffer.size())};
+    bool missing_control_points = false;
+    for (auto& face : face_data) {
+        if (!face->regular && face->Valence() == 4) {
+            if (face->HasControlPoints()) {
+                FillMissingControlPoints(*face, missing_points);
+            } else {
+                missing_control_points = true;
+            }
+        }
+    }
+
+    if (!missing_control_points) {
+        AddMissingPoints(missing_points, vertex_buffer);
+        return;
+    }
+
+    // Faces split from other polygons take their control points from their one ring in the refined mesh instead. The
+    // faces of the last level only share vertices with each other, so the regular faces kept from earlier levels are
+    // separate pieces of this mesh and don't get in the way.
+    HalfEdgeMesh mesh{GenerateHalfEdgeMesh(face_data, missing_points.end, EdgePairing::RadixSort, num_threads)};
+    GenerateVertexValences(mesh, num_threads);
+
+    std::vector<FaceData*> end_caps;
+    for (int f = 0; f < mesh.NumFaces(); ++f) {
+        FaceData& face = *face_data[f];
+        if (!face.regular && face.Valence() == 4 && !face.HasControlPoints()) {
+            FaceControlPoints(mesh, f, face);
+            end_caps.push_back(&face);
+        }
+    }
+
+    AddPhantomControlPoints(mesh, face_data, missing_points);
+
+    // The grids are built in the order of the faces' vertices, so turn them to match the rest of their patch face.
+    for (auto& face : end_caps) {
+        FillMissingControlPoints(*face, missing_points);
+        RotateControlPoints(face->control_points, face->grid_rotation);
+    }
+
+    AddMissingPoints(missing_points, vertex_buffer);
+}
+
+void RotateControlPoints(std::array<int, 16>& control_points, int quarter_turns) {
+    for (int turn = 0; turn < quarter_turns; ++turn) {
+        // Corner 0 of the grid moves to corner 1, and so on.
+        std::array<int, 16> rotated;
+        for (int row = 0; row < 4; ++row) {
+            for (int col = 0; col < 4; ++col) {
+                rotated[col * 4 + 3 - row] = control_points[row * 4 + col];
+            }
+        }
+
+        control_points = rotated;
+    }
+}
+
+template<typename Point>
+void InsertFaceVertex(const FaceData& face, std::vector<Point>& vertex_buffer) {
+    // Every point of a level has its slot before any are computed, so nothing here grows the buffer.
+    assert(face.inserted_vertex >= 0 && face.inserted_vertex < static_cast<int>(vertex_buffer.size()));
+    Point new_vertex{vertex_buffer[face.vertices[0]]};
+    for (int v = 1; v < face.Valence(); ++v) {
+        new_vertex += vertex_buffer[face.vertices[v]];
+    }
+
+    vertex_buffer[face.inserted_vertex] = new_vertex / static_cast<float>(face.Valence());
+}
+
+template<typename Point>
+void InsertEdgeVertex(const EdgeData& edge, std::vector<Point>& vertex_buffer) {
+    assert(edge.inserted_vertex >= 0 && edge.inserted_vertex < static_cast<int>(vertex_buffer.size()));
+    if (edge.OnBoundary()) {
+        Point new_vertex{vertex_buffer[edge.vertices[0]] + vertex_buffer[edge.vertices[1]]};
+        vertex_buffer[edge.inserted_vertex] = new_vertex / 2.0f;
+    } else {
+        // The face vertices of both adjacent faces have already been computed.
+        Point new_vertex{vertex_buffer[edge.vertices[0]] +
+                         vertex_buffer[edge.vertices[1]] +
+                         vertex_buffer[edge.adjacent_faces[0]->inserted_vertex] +
+                         vertex_buffer[edge.adjacent_faces[1]->inserted_vertex]};
+        vertex_buffer[edge.inserted_vertex] = new_vertex / 4.0f;
+    }
+}
+
+template<typename Point>
+void RefineControlVertexGeneric(const VertexData& vertex, const int* one_ring, std::vector<Point>& vertex_buffer) {
+    assert(vertex.inserted_vertex >= 0 && vertex.inserted_vertex < static_cast<int>(vertex_buffer.size()));
+    Point new_vertex;
+
+    if (vertex.OnBoundary()) {
+        new_vertex = vertex_buffer[vertex.boundary_vertices[0]];
+        for (std::size_t i = 1; i < vertex.boundary_vertices.size(); ++i) {
+            new_vertex += vertex_buffer[vertex.boundary_vertices[i]];
+        }
+        new_vertex += 6.0f * vertex_buffer[vertex.predecessor];
+
+        new_vertex /= 8.0f;
+    } else {
+        // The other end of each edge, then the face point of each face.
+        const int ring_size = vertex.Valence() + vertex.FaceValence();
+        new_vertex = vertex_buffer[one_ring[0]];
+        for (int i = 1; i < ring_size; ++i) {
+            new_vertex += vertex_buffer[one_ring[i]];
+        }
+
+        float valence_f = vertex.Valence();
+        new_vertex /= valence_f * valence_f;
+        new_vertex += vertex_buffer[vertex.predecessor] * (valence_f - 2.0f) / valence_f;
+    }
+
+    vertex_buffer[vertex.inserted_vertex] = new_vertex;
+}
+
+namespace {
+
+// The kernels below do the same arithmetic in the same order as RefineControlVertexGeneric(), so each vertex point
+// comes out bit for bit the same whichever kernel computes it.
+
+// An interior vertex with valence edges and faces, whose one ring is a fixed-length run of indices.
+template<int valence, typename Point>
+void RefineInteriorVertex(const VertexData& vertex, const int* one_ring, std::vector<Point>& vertex_buffer) {
+    assert(vertex.Valence() == valence && vertex.FaceValence() == valence && !vertex.OnBoundary());
+    assert(vertex.inserted_vertex >= 0 && vertex.inserted_vertex < static_cast<int>(vertex_buffer.size()));
+
+    constexpr float valence_f = valence;
+    constexpr float ring_divisor = valence_f * valence_f;
+    constexpr float vertex_weight = valence_f - 2.0f;
+
+    Point new_vertex{vertex_buffer[one_ring[0]]};
+    for (int i = 1; i < 2 * valence; ++i) {
+        new_vertex += vertex_buffer[one_ring[i]];
+    }
+
+    new_vertex /= ring_divisor;
+    new_vertex += vertex_buffer[vertex.predecessor] * vertex_weight / valence_f;
+
+    vertex_buffer[vertex.inserted_vertex] = new_vertex;
+}
+
+// The kernels of interior vertices, indexed by valence. The valences below three can't occur on a closed surface,
+// and the ones above max_specialized_valence are too rare to be worth a kernel of their own.
+constexpr int max_specialized_valence = 8;
+
+template<typename Point>
+constexpr std::array<VertexPointKernel<Point>, max_specialized_valence + 1> interior_vertex_kernels{{
+    &RefineControlVertexGeneric<Point>, &RefineControlVertexGeneric<Point>, &RefineControlVertexGeneric<Point>,
+    &RefineInteriorVertex<3, Point>, &RefineInteriorVertex<4, Point>, &RefineInteriorVertex<5, Point>,
+    &RefineInteriorVertex<6, Point>, &RefineInteriorVertex<7, Point>, &RefineInteriorVertex<8, Point>}};
+
+} // End anonymous namespace
+
+template<typename Point>
+VertexPointKernel<Point> SelectVertexPointKernel(const VertexData& vertex) {
+    // A boundary vertex only reads its neighbours along the boundary, and a kernel of its own measured no faster than
+    // the generic one. Non-manifold vertices can have a different number of edges and faces, which only the generic
+    // kernel handles.
+    const int valence = vertex.Valence();
+    if (vertex.OnBoundary() || valence > max_specialized_valence || vertex.FaceValence() != valence) {
+        return &RefineControlVertexGeneric<Point>;
+    }
+
+    return interior_vertex_kernels<Point>[valence];
+}
+
+template<typename Point>
+void RefineControlVertex(const VertexData& vertex, const int* one_ring, std::vector<Point>& vertex_buffer) {
+    SelectVertexPointKernel<Point>(vertex)(vertex, one_ring, vertex_buffer);
+}
+
+LevelPoints AllocateLevelPoints(int first_point,
+                                std::vector<FaceDataPtr>& face_data,
+                                std::vector<VertexData>& vertex_data) {
+    LevelPoints level_points;
+    int next_point = first_point;
+
+    // The control points of the subpatches of each irregular face come first, in face order.
+    for (auto& face : face_data) {
+        if (face->Refines() && face->HasControlPoints()) {
+            level_points.subdivided_faces.push_back(face.get());
+            face->first_subdivided_point = next_point;
+            next_point += 25;
+        }
+    }
+
+    level_points.refined_begin = next_point;
+
+    // Then the face, edge and vertex points around the irregular vertices, each in the order they are first reached
+    // from vertex_data. Faces are numbered as they are reached, while regular faces may still hold a face point from
+    // the previous level, which lies below refined_begin. Edges reached more than once are marked as pending the first
+    // time, and numbered after the faces. The one ring of each vertex is gathered on the way, so the vertex points
+    // don't go through the adjacent edges and faces again.
+    constexpr int pending_point = -2;
+    level_points.ring_offsets.reserve(vertex_data.size() + 1);
+    level_points.ring_offsets.push_back(0);
+    level_points.rings.reserve(8 * vertex_data.size());
+    for (auto& vertex : vertex_data) {
+        for (auto& face : vertex.adjacent_faces) {
+            if (face->inserted_vertex < level_points.refined_begin) {
+                face->inserted_vertex = level_points.refined_begin + level_points.faces.size();
+                level_points.faces.push_back(face);
+            }
+        }
+
+        auto& rings = level_points.rings;
+        for (auto& edge : vertex.adjacent_edges) {
+            if (edge->inserted_vertex != pending_point) {
+                edge->inserted_vertex = pending_point;
+                level_points.edges.push_back(edge);
+            }
+            if (!vertex.OnBoundary()) {
+                rings.push_back((edge->vertices[0] == vertex.predecessor) ? edge->vertices[1] : edge->vertices[0]);
+            }
+        }
+
+        if (!vertex.OnBoundary()) {
+            for (const auto& face : vertex.adjacent_faces) {
+                rings.push_back(face->inserted_vertex);
+            }
+        }
+        level_points.ring_offsets.push_back(rings.size());
+    }
+
+    next_point += level_points.faces.size();
+    for (auto& edge : level_points.edges) {
+        edge->inserted_vertex = next_point++;
+    }
+
+    for (auto& vertex : vertex_data) {
+        vertex.inserted_vertex = next_point++;
+    }
+
+    level_points.end = next_point;
+
+    return level_points;
+}
+
+template<typename Point>
+void CreateNewFaces(std::vector<Point>& vertex_buffer,
+                    std::vector<FaceDataPtr>& face_data,
+                    std::vector<EdgeData>& edge_data,
+                    std::vector<VertexData>& vertex_data,
+                    int num_threads,
+                    RefinementArenas* arenas) {
+    // Every new point of this level gets its index before any of them are computed, so the points can be computed in
+    // parallel straight into their slots, and the layout of the vertex buffer does not depend on the thread count.
+    const LevelPoints level_points{AllocateLevelPoints(vertex_buffer.size(), face_data, vertex_data)};
+    vertex_buffer.resize(level_points.end);
+
+    // Each pass only reads points from the control mesh and earlier passes.
+    SubdivideControlPoints(level_points.subdivided_faces, vertex_buffer, num_threads);
+
+    ParallelFor(0, level_points.faces.size(), num_threads, [&](int faces_begin, int faces_end) {
+        for (int f = faces_begin; f < faces_end; ++f) {
+            InsertFaceVertex(*level_points.faces[f], vertex_buffer);
+        }
+    });
+
+    ParallelFor(0, level_points.edges.size(), num_threads, [&](int edges_begin, int edges_end) {
+        for (int e = edges_begin; e < edges_end; ++e) {
+            InsertEdgeVertex(*level_points.edges[e], vertex_buffer);
+        }
+    });
+
+    ParallelFor(0, vertex_data.size(), num_threads, [&](int vertices_begin, int vertices_end) {
+        for (int v = vertices_begin; v < vertices_end; ++v) {
+            RefineControlVertex(vertex_data[v], level_points.OneRing(v), vertex_buffer);
+        }
+    });
+
+    // The new faces go in the arena of the refinement, and the connectivity of the new level in the arena of the
+    // level before last, which nothing points into any more.
+    Arena* face_arena = (arenas != nullptr) ? &arenas->faces : nullptr;
+    Arena* level_arena = (arenas != nullptr) ? &arenas->NextLevel() : nullptr;
+
+    std::size_t num_split_faces = 0, num_kept_faces = 0;
+    for (const auto& face : face_data) {
+        if (face->Refines()) {
+            num_split_faces += face->Valence();
+        } else {
+            ++num_kept_faces;
+        }
+    }
+
+    std::vector<FaceDataPtr> new_face_data;
+    new_face_data.reserve(num_split_faces + num_kept_faces);
+    // Each split face has four edges, and nearly all of them are shared by two faces.
+    EdgeIndexMap edge_indices{2 * num_split_faces, std::hash<EdgeKey>{}, std::equal_to<EdgeKey>{}, level_arena};
+    std::vector<EdgeData> new_edge_data;
+
+    for (auto& vertex : vertex_data) {
+        if (!vertex.adjacent_irregular) {
+            continue;
+        }
+
+        // After the control mesh vertex has been refined, we can add four new faces.
+        for (const auto& face : vertex.adjacent_faces) {
+            if (face->Refines()) {
+                // For each irregular face, iterate over it's edges to find the two adjacent to the current vertex.
+                std::array<const EdgeData*, 2> face_edges;
+                int num_face_edges = 0;
+                for (const auto& edge : vertex.adjacent_edges) {
+                    if (edge->adjacent_faces[0] == face || edge->adjacent_faces[1] == face) {
+                        if (num_face_edges < 2) {
+                            face_edges[num_face_edges] = edge;
+                        }
+                        ++num_face_edges;
+                    }
+                }
+
+                if (num_face_edges != 2) {
+                    throw std::runtime_error("Did not find two adjacent edges for face. Found " +
+                                             std::to_string(num_face_edges));
+                }
+
+                // Create the new face. The parent face is wound counterclockwise, so its subface at this corner is
+                // too if it runs from the face vertex through the edge before the corner to the edge after it.
+                const int corner = IndexOfVertexInFace(face, vertex.predecessor);
+                const int next_vertex = face->vertices[(corner + 1) % face->Valence()];
+                if (face_edges[0]->vertices[0] == next_vertex || face_edges[0]->vertices[1] == next_vertex) {
+                    std::swap(face_edges[0], face_edges[1]);
+                }
+
+                ArenaVector<int> face_indices({face->inserted_vertex,
+                                               face_edges[0]->inserted_vertex,
+                                               vertex.inserted_vertex,
+                                               face_edges[1]->inserted_vertex}, face_arena);
+                // The face point of a quad and the edge points are regular, so the new face is regular if the
+                // corner it was split from was. Other polygons have no control points to split, so their new faces
+                // and all of their descendants stay irregular, and end up as end caps.
+                const bool parent_quad = face->Valence() == 4;
+                const bool regular_corner = parent_quad && face->regular_corners[corner];
+                new_face_data.push_back(MakeFaceData(face_arena, std::move(face_indices), regular_corner));
+                FaceData& new_face = *new_face_data.back();
+                new_face.regular_corners = {parent_quad, parent_quad, regular_corner, parent_quad};
+                new_face.max_depth = face->max_depth;
+
+                // Find edges for the newly created face.
+                FindFaceEdges(edge_indices, new_edge_data, &new_face);
+
+                if (!parent_quad) {
+                    // Each corner of another polygon starts a patch face of its own, oriented by its vertices.
+                    new_face.patch_face = face->patch_face + corner;
+                    new_face.control_points.fill(-1);
+                    continue;
+                }
+
+                // Determine the quadrant of the parent's grid the new face is in. The corner vertex sits at the same
+                // corner of the new face's grid, and the face point at the opposite one, which is vertices[0].
+                const int quadrant = (corner + face->grid_rotation) % 4;
+                int row_offset, col_offset;
+                std::tie(row_offset, col_offset) = SubpatchOffset(quadrant);
+
+                new_face.grid_rotation = (quadrant + 2) % 4;
+                new_face.patch_face = face->patch_face;
+                new_face.depth = face->depth + 1;
+                new_face.domain_row = face->domain_row * 2 + row_offset;
+                new_face.domain_col = face->domain_col * 2 + col_offset;
+
+                if (!face->HasControlPoints()) {
+                    new_face.control_points.fill(-1);
+                    continue;
+                }
+
+                for (int i = 0; i < 4; ++i) {
+                    for (int j = 0; j < 4; ++j) {
+                        int point_index = face->SubdividedPoint((i + row_offset) * 5 + (j + col_offset));
+                        new_face.control_points[i * 4 + j] = point_index;
+                    }
+                }
+            }
+        }
+    }
+
+    // Copy all regular faces and end caps.
+    for (auto& face : face_data) {
+        if (!face->Refines()) {
+            new_face_data.push_back(std::move(face));
+        }
+    }
+
+    // Replace the old mesh data.
+    face_data = std::move(new_face_data);
+    edge_data = std::move(new_edge_data);
+    vertex_data = GenerateIrregularVertexConnectivity(edge_data, level_points.refined_begin, level_points.end,
+                                                      level_arena);
+}
+
+template<typename Point>
+void SubdivideControlPoints(const std::vector<FaceData*>& faces, std::vector<Point>& vertex_buffer, int num_threads) {
+    ParallelFor(0, faces.size(), num_threads, [&faces, &vertex_buffer](int faces_begin, int faces_end) {
+        for (int f = faces_begin; f < faces_end; ++f) {
+            SubdivideControlPoints(*faces[f], vertex_buffer);
+        }
+    });
+}
+
+template<>
+void SubdivideControlPoints(const std::vector<FaceData*>& faces, std::vector<glm::vec3>& vertex_buffer,
+                            int num_threads) {
+    // Positions are split a batch of faces at a time by the SIMD kernel, one face per lane.
+    const int num_faces = faces.size();
+    const int num_batches = (num_faces + patch_batch_size - 1) / patch_batch_size;
+
+    ParallelFor(0, num_batches, num_threads, [&faces, &vertex_buffer, num_faces](int batches_begin, int batches_end) {
+        PatchBatch patches;
+        SubpatchBatch subpatches;
+
+        for (int b = batches_begin; b < batches_end; ++b) {
+            const int first_face = b * patch_batch_size;
+            const int batch_faces = std::min(patch_batch_size, num_faces - first_face);
+
+            // Missing control points contribute nothing, and neither do the lanes past the last face.
+            for (int l = 0; l < patch_batch_size; ++l) {
+                for (int i = 0; i < 16; ++i) {
+                    glm::vec3 point{};
+                    if (l < batch_faces && faces[first_face + l]->control_points[i] != -1) {
+                        point = vertex_buffer[faces[first_face + l]->control_points[i]];
+                    }
+
+                    patches.points[i][0][l] = point.x;
+                    patches.points[i][1][l] = point.y;
+                    patches.points[i][2][l] = point.z;
+                }
+            }
+
+            SubdividePatchBatch(patches, subpatches);
+
+            for (int l = 0; l < batch_faces; ++l) {
+                const FaceData& face = *faces[first_face + l];
+                for (int i = 0; i < 25; ++i) {
+                    vertex_buffer[face.SubdividedPoint(i)] = glm::vec3{subpatches.points[i][0][l],
+                                                                       subpatches.points[i][1][l],
+                                                                       subpatches.points[i][2][l]};
+                }
+            }
+        }
+    });
+}
+
+template<typename Point>
+void SubdivideControlPoints(const FaceData& face, std::vector<Point>& vertex_buffer) {
+    // The same separable split as SubdividePatchBatch, for point types the SIMD kernel can't handle. Missing control
+    // points contribute nothing.
+    auto control_point = [&face, &vertex_buffer](int row, int col) {
+        const int point_index = face.control_points[row * 4 + col];
+        return (point_index == -1) ? Point{} : vertex_buffer[point_index];
+    };
+
+    std::array<std::array<Point, 5>, 4> rows;
+    for (int row = 0; row < 4; ++row) {
+        rows[row] = SplitCurve(control_point(row, 0), control_point(row, 1),
+                               control_point(row, 2), control_point(row, 3));
+    }
+
+    for (int col = 0; col < 5; ++col) {
+        const auto column{SplitCurve(rows[0][col], rows[1][col], rows[2][col], rows[3][col])};
+        for (int row = 0; row < 5; ++row) {
+            vertex_buffer[face.SubdividedPoint(row * 5 + col)] = column[row];
+        }
+    }
+}
+
+template<typename Point>
+std::array<Point, 5> SplitCurve(const Point& p0, const Point& p1, const Point& p2, const Point& p3) {
+    return {{(p0 + p1) * 0.5f,
+             (p0 + p1 * 6.0f + p2) * 0.125f,
+             (p1 + p2) * 0.5f,
+             (p1 + p2 * 6.0f + p3) * 0.125f,
+             (p2 + p3) * 0.5f}};
+}
+
+std::tuple<int, int> SubpatchOffset(int face_corner) {
+    switch (face_corner) {
+    case 0:
+        return std::make_tuple(0, 0);
+    case 1:
+        return std::make_tuple(0, 1);
+    case 2:
+        return std::make_tuple(1, 1);
+    case 3:
+        return std::make_tuple(1, 0);
+    default:
+        throw std::runtime_error("Invalid value given for face vertex index: " + std::to_string(face_corner));
+    }
+}
+
+std::array<std::array<float, 16>, 25> GetStencilWeights() {
+    std::array<std::array<float, 16>, 25> stencil;
+
+    stencil[0] = {{
+        1.0f/4.0f, 1.0f/4.0f, 0, 0,
+        1.0f/4.0f, 1.0f/4.0f, 0, 0,
+        0, 0, 0, 0,
+        0, 0, 0, 0
+    }};
+    stencil[1] = {{
+        1.0f/16.0f, 3.0f/8.0f, 1.0f/16.0f, 0,
+        1.0f/16.0f, 3.0f/8.0f, 1.0f/16.0f, 0,
+        0, 0, 0, 0,
+        0, 0, 0, 0
+    }};
+    stencil[2] = {{
+        0, 1.0f/4.0f, 1.0f/4.0f, 0,
+        0, 1.0f/4.0f, 1.0f/4.0f, 0,
+        0, 0, 0, 0,
+        0, 0, 0, 0
+    }};
+    stencil[3] = {{
+        0, 1.0f/16.0f, 3.0f/8.0f, 1.0f/16.0f,
+        0, 1.0f/16.0f, 3.0f/8.0f, 1.0f/16.0f,
+        0, 0, 0, 0,
+        0, 0, 0, 0
+    }};
+    stencil[4] = {{
+        0, 0, 1.0f/4.0f, 1.0f/4.0f,
+        0, 0, 1.0f/4.0f, 1.0f/4.0f,
+        0, 0, 0, 0,
+        0, 0, 0, 0
+    }};
+
+    stencil[5] = {{
+        1.0f/16.0f, 1.0f/16.0f, 0, 0,
+        3.0f/8.0f, 3.0f/8.0f, 0, 0,
+        1.0f/16.0f, 1.0f/16.0f, 0, 0,
+        0, 0, 0, 0
+    }};
+    stencil[6] = {{
+        1.0f/64.0f, 3.0f/32.0f, 1.0f/64.0f, 0,
+        3.0f/32.0f, 9.0f/16.0f, 3.0f/32.0f, 0,
+        1.0f/64.0f, 3.0f/32.0f, 1.0f/64.0f, 0,
+        0, 0, 0, 0
+    }};
+    stencil[7] = {{
+        0, 1.0f/16.0f, 1.0f/16.0f, 0,
+        0, 3.0f/8.0f, 3.0f/8.0f, 0,
+        0, 1.0f/16.0f, 1.0f/16.0f, 0,
+        0, 0, 0, 0
+    }};
+    stencil[8] = {{
+        0, 1.0f/64.0f, 3.0f/32.0f, 1.0f/64.0f,
+        0, 3.0f/32.0f, 9.0f/16.0f, 3.0f/32.0f,
+        0, 1.0f/64.0f, 3.0f/32.0f, 1.0f/64.0f,
+        0, 0, 0, 0
+    }};
+    stencil[9] = {{
+        0, 0, 1.0f/16.0f, 1.0f/16.0f,
+        0, 0, 3.0f/8.0f, 3.0f/8.0f,
+        0, 0, 1.0f/16.0f, 1.0f/16.0f,
+        0, 0, 0, 0
+    }};
+
+    stencil[10] = {{
+        0, 0, 0, 0,
+        1.0f/4.0f, 1.0f/4.0f, 0, 0,
+        1.0f/4.0f, 1.0f/4.0f, 0, 0,
+        0, 0, 0, 0
+    }};
+    stencil[11] = {{
+        0, 0, 0, 0,
+        1.0f/16.0f, 3.0f/8.0f, 1.0f/16.0f, 0,
+        1.0f/16.0f, 3.0f/8.0f, 1.0f/16.0f, 0,
+        0, 0, 0, 0
+    }};
+    stencil[12] = {{
+        0, 0, 0, 0,
+        0, 1.0f/4.0f, 1.0f/4.0f, 0,
+        0, 1.0f/4.0f, 1.0f/4.0f, 0,
+        0, 0, 0, 0
+    }};
+    stencil[13] = {{
+        0, 0, 0, 0,
+        0, 1.0f/16.0f, 3.0f/8.0f, 1.0f/16.0f,
+        0, 1.0f/16.0f, 3.0f/8.0f, 1.0f/16.0f,
+        0, 0, 0, 0
+    }};
+    stencil[14] = {{
+        0, 0, 0, 0,
+        0, 0, 1.0f/4.0f, 1.0f/4.0f,
+        0, 0, 1.0f/4.0f, 1.0f/4.0f,
+        0, 0, 0, 0
+    }};
+
+    stencil[15] = {{
+        0, 0, 0, 0,
+        1.0f/16.0f, 1.0f/16.0f, 0, 0,
+        3.0f/8.0f, 3.0f/8.0f, 0, 0,
+        1.0f/16.0f, 1.0f/16.0f, 0, 0
+    }};
+    stencil[16] = {{
+        0, 0, 0, 0,
+        1.0f/64.0f, 3.0f/32.0f, 1.0f/64.0f, 0,
+        3.0f/32.0f, 9.0f/16.0f, 3.0f/32.0f, 0,
+        1.0f/64.0f, 3.0f/32.0f, 1.0f/64.0f, 0
+    }};
+    stencil[17] = {{
+        0, 0, 0, 0,
+        0, 1.0f/16.0f, 1.0f/16.0f, 0,
+        0, 3.0f/8.0f, 3.0f/8.0f, 0,
+        0, 1.0f/16.0f, 1.0f/16.0f, 0
+    }};
+    stencil[18] = {{
+        0, 0, 0, 0,
+        0, 1.0f/64.0f, 3.0f/32.0f, 1.0f/64.0f,
+        0, 3.0f/32.0f, 9.0f/16.0f, 3.0f/32.0f,
+        0, 1.0f/64.0f, 3.0f/32.0f, 1.0f/64.0f
+    }};
+    stencil[19] = {{
+        0, 0, 0, 0,
+        0, 0, 1.0f/16.0f, 1.0f/16.0f,
+        0, 0, 3.0f/8.0f, 3.0f/8.0f,
+        0, 0, 1.0f/16.0f, 1.0f/16.0f
+    }};
+
+    stencil[20] = {{
+        0, 0, 0, 0,
+        0, 0, 0, 0,
+        1.0f/4.0f, 1.0f/4.0f, 0, 0,
+        1.0f/4.0f, 1.0f/4.0f, 0, 0
+    }};
+    stencil[21] = {{
+        0, 0, 0, 0,
+        0, 0, 0, 0,
+        1.0f/16.0f, 3.0f/8.0f, 1.0f/16.0f, 0,
+        1.0f/16.0f, 3.0f/8.0f, 1.0f/16.0f, 0
+    }};
+    stencil[22] = {{
+        0, 0, 0, 0,
+        0, 0, 0, 0,
+        0, 1.0f/4.0f, 1.0f/4.0f, 0,
+        0, 1.0f/4.0f, 1.0f/4.0f, 0
+    }};
+    stencil[23] = {{
+        0, 0, 0, 0,
+        0, 0, 0, 0,
+        0, 1.0f/16.0f, 3.0f/8.0f, 1.0f/16.0f,
+        0, 1.0f/16.0f, 3.0f/8.0f, 1.0f/16.0f
+    }};
+    stencil[24] = {{
+        0, 0, 0, 0,
+        0, 0, 0, 0,
+        0, 0, 1.0f/4.0f, 1.0f/4.0f,
+        0, 0, 1.0f/4.0f, 1.0f/4.0f
+    }};
+
+    return stencil;
+}
+
+template PatchTable SubdividePatches(const TinyObjMesh&, std::vector<glm::vec3>&, int, const RefinementOptions&,
+                                     const StageCallback<glm::vec3>&);
+template PatchTable SubdividePatches(const TinyObjMesh&, std::vector<Stencil>&, int, const RefinementOptions&,
+                                     const StageCallback<Stencil>&);
+template void SubdivideFaces(std::vector<FaceDataPtr>&, std::vector<glm::vec3>&, const RefinementOptions&, int,
+                             const StageCallback<glm::vec3>&, RefinementArenas*);
+template void SubdivideFaces(std::vector<FaceDataPtr>&, std::vector<Stencil>&, const RefinementOptions&, int,
+                             const StageCallback<Stencil>&, RefinementArenas*);
+template void CompleteControlPoints(const HalfEdgeMesh&, std::vector<FaceDataPtr>&, std::vector<glm::vec3>&);
+template void CompleteControlPoints(const HalfEdgeMesh&, std::vector<FaceDataPtr>&, std::vector<Stencil>&);
+template void AddMissingPoints(const MissingPoints&, std::vector<glm::vec3>&);
+template void AddMissingPoints(const MissingPoints&, std::vector<Stencil>&);
+template void AddEndCaps(std::vector<FaceDataPtr>&, std::vector<glm::vec3>&, int);
+template void AddEndCaps(std::vector<FaceDataPtr>&, std::vector<Stencil>&, int);
+template void InsertFaceVertex(const FaceData&, std::vector<glm::vec3>&);
+template void InsertFaceVertex(const FaceData&, std::vector<Stencil>&);
+template void InsertEdgeVertex(const EdgeData&, std::vector<glm::vec3>&);
+template void InsertEdgeVertex(const EdgeData&, std::vector<Stencil>&);
+template void RefineControlVertex(const VertexData&, const int*, std::vector<glm::vec3>&);
+template void RefineControlVertex(const VertexData&, const int*, std::vector<Stencil>&);
+template void RefineControlVertexGeneric(const VertexData&, const int*, std::vector<glm::vec3>&);
+template void RefineControlVertexGeneric(const VertexData&, const int*, std::vector<Stencil>&);
+template VertexPointKernel<glm::vec3> SelectVertexPointKernel(const VertexData&);
+template VertexPointKernel<Stencil> SelectVertexPointKernel(const VertexData&);
+template void CreateNewFaces(std::vector<glm::vec3>&, std::vector<FaceDataPtr>&,
+                             std::vector<EdgeData>&, std::vector<VertexData>&, int, RefinementArenas*);
+template void CreateNewFaces(std::vector<Stencil>&, std::vector<FaceDataPtr>&,
+                             std::vector<EdgeData>&, std::vector<VertexData>&, int, RefinementArenas*);
+template void SubdivideControlPoints(const std::vector<FaceData*>&, std::vector<Stencil>&, int);
+template void SubdivideControlPoints(const FaceData&, std::vector<glm::vec3>&);
+template void SubdivideControlPoints(const FaceData&, std::vector<Stencil>&);
+template std::array<glm::vec3, 5> SplitCurve(const glm::vec3&, const glm::vec3&, const glm::vec3&, const glm::vec3&);
+template std::array<Stencil, 5> SplitCurve(const Stencil&, const Stencil&, const Stencil&, const Stencil&);
+
+} // End namespace Subdivision
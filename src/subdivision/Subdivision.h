@@ -0,0 +1,212 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+
+#include <glm/glm.hpp>
+
+#include "externals/tiny_obj_loader.h"
+#include "subdivision/Arena.h"
+#include "subdivision/Connectivity.h"
+#include "subdivision/HalfEdge.h"
+#include "subdivision/Stencil.h"
+
+namespace Subdivision {
+
+struct TinyObjMesh;
+struct IndexedMesh;
+struct PatchBounds;
+
+// How far the refinement isolates extraordinary vertices and polygons other than quads. Irregular regions are refined
+// up to max_depth levels. face_priorities, if given, holds a priority in [0, 1] for each face of the control mesh, in
+// the order of the .obj file, such as an estimate of its size on screen or of its curvature. A face then asks for
+// ceil(priority * max_depth) levels. Irregular faces which share a vertex are refined together, down to the deepest
+// level any of them asks for, and whatever is still irregular there becomes end caps. Polygons other than quads are
+// always split at least once, since only quads become patches.
+struct RefinementOptions {
+    int max_depth = 2;
+    std::vector<float> face_priorities;
+};
+
+// Bits of PatchTable::flags.
+// The patch approximates the surface around an extraordinary vertex, instead of matching it exactly.
+constexpr std::uint8_t patch_end_cap = 1 << 0;
+// The patch lies on a polygon of the control mesh other than a quad.
+constexpr std::uint8_t patch_polygon = 1 << 1;
+
+// The patches left after refinement, as separate arrays, so the faces the refinement works on can be thrown away
+// once it is done. Each patch has 16 indices into the vertex buffer, a byte of flags, and its level: the number of
+// times its patch face was split to get it, which makes it cover a 1/2^level by 1/2^level square of the patch face.
+struct PatchTable {
+    std::vector<int> indices;
+    std::vector<std::uint8_t> flags;
+    std::vector<std::uint8_t> levels;
+
+    int NumPatches() const { return flags.size(); }
+};
+
+// num_threads is the number of worker threads used to build the base mesh connectivity and to compute the points of
+// each level. The output does not depend on it.
+IndexedMesh SubdivideMesh(const TinyObjMesh& obj_data, int num_threads = 1, const RefinementOptions& options = {});
+StencilMesh RecordStencilMesh(const TinyObjMesh& obj_data, int num_threads = 1,
+                              const RefinementOptions& options = {});
+
+// A face priority for RefinementOptions from how sharply the control mesh bends around each face: the largest angle
+// between the normal of the face and the average normal at one of its vertices, over full_angle, at most 1.
+std::vector<float> CurvaturePriorities(const TinyObjMesh& obj_data, float full_angle = 0.5f);
+
+// The bounds of each B-spline patch of 16 indices into vertices. SubdivideMesh() fills these in already.
+std::vector<PatchBounds> ComputePatchBounds(const std::vector<glm::vec3>& vertices, const std::vector<int>& indices,
+                                            int num_threads = 1);
+
+// The refinement below only ever adds and scales points, so it is templated on the point type: glm::vec3 computes
+// positions directly, while Stencil records the weights of each point for later evaluation with a StencilTable.
+// If given, end_stage is called with the vertex buffer after each stage which adds points: the control points of the
+// patch faces, each level, and the end caps. A stage only reads the points before it, and never writes to them.
+template<typename Point>
+using StageCallback = std::function<void(std::vector<Point>&)>;
+
+template<typename Point>
+PatchTable SubdividePatches(const TinyObjMesh& obj_data, std::vector<Point>& vertex_buffer, int num_threads,
+                            const RefinementOptions& options = {}, const StageCallback<Point>& end_stage = {});
+// If arenas is given, the faces, edges and vertices of each level are allocated from it instead of one by one from
+// the heap. It must then outlive face_data, which ends up holding faces from its arena.
+template<typename Point>
+void SubdivideFaces(std::vector<FaceDataPtr>& face_data, std::vector<Point>& vertex_buffer,
+                    const RefinementOptions& options, int num_threads, const StageCallback<Point>& end_stage = {},
+                    RefinementArenas* arenas = nullptr);
+
+// Sets the max_depth of each face of the control mesh from the options. Returns the deepest.
+int SetMaxDepths(std::vector<FaceDataPtr>& face_data, const RefinementOptions& options);
+
+// Marks the irregular faces whose region stops refining at this level as end caps, and drops the vertices around them
+// from vertex_data. The regions are the sets of irregular faces connected through shared vertices, which is what
+// keeps the one ring of an end cap together at the level it stops at.
+void CapIsolatedRegions(std::vector<VertexData>& vertex_data, int level);
+
+// Numbers the patch faces of the control mesh, which subdivision plans and their evaluation are organised by: each
+// quad is a patch face, and so is each corner of the other polygons. Returns the number of patch faces.
+int NumberPatchFaces(std::vector<FaceDataPtr>& face_data);
+
+// Adds the control points which GenerateControlPoints() leaves out: phantom points across the boundary, and the rest
+// of the grids of irregular quads.
+template<typename Point>
+void CompleteControlPoints(const HalfEdgeMesh& mesh, std::vector<FaceDataPtr>& face_data,
+                           std::vector<Point>& vertex_buffer);
+
+// The control points added to fill in the grids of some faces, numbered from the end of the vertex buffer in the order
+// they are found. Which points are missing only depends on the topology, so they are all numbered first, and then
+// the vertex buffer is grown once and each point computed into its slot.
+struct MissingPoints {
+    // A point mirrored across another, 2 * from[0] - from[1], or completing a parallelogram,
+    // from[0] + from[1] - from[2]. from[2] is -1 for mirrored points.
+    struct Missing {
+        int point;
+        std::array<int, 3> from;
+    };
+
+    int end;
+    std::vector<Missing> points;
+
+    explicit MissingPoints(int first_point) : end(first_point) {}
+
+    // Numbers a new point computed from the given ones, which may be missing points numbered before it.
+    int Add(int from0, int from1, int from2 = -1);
+};
+
+// Grows vertex_buffer up to missing_points.end, and computes each missing point in the order they were numbered.
+template<typename Point>
+void AddMissingPoints(const MissingPoints& missing_points, std::vector<Point>& vertex_buffer);
+
+// Fills in the control points which GenerateControlPoints() left out on boundary faces, by mirroring the points
+// inside the boundary across it: p = 2b - i. The boundary curves of the patches are then the cubic B-splines of the
+// boundary vertices, matching the boundary rules used by the refinement, and the patches interpolate corners.
+void AddPhantomControlPoints(const HalfEdgeMesh& mesh, std::vector<FaceDataPtr>& face_data,
+                             MissingPoints& missing_points);
+
+// Fills in any control points of a quad which are still missing, such as the point diagonally across an
+// extraordinary vertex. Points on the sides of the grid are mirrored across the face as above, and corners of the
+// grid complete the parallelogram of their three neighbours.
+void FillMissingControlPoints(FaceData& face, MissingPoints& missing_points);
+
+// Turns every quad which is still irregular after the last level of its region into an end cap: a B-spline patch
+// which approximates the surface around its extraordinary vertex, so that a small depth leaves no holes. Faces split
+// from a quad keep the subpatch of their parent. Faces split from other polygons use their one ring in the refined
+// mesh. Missing points are filled in either way.
+template<typename Point>
+void AddEndCaps(std::vector<FaceDataPtr>& face_data, std::vector<Point>& vertex_buffer, int num_threads);
+
+// Turns a control point grid by the given number of quarter turns, each of which moves grid corner 0 to corner 1.
+void RotateControlPoints(std::array<int, 16>& control_points, int quarter_turns);
+
+// The points created by one level of refinement. Each level appends the subdivided control points of its irregular
+// faces, then the face points, edge points and vertex points around its irregular vertices, in that order.
+struct LevelPoints {
+    std::vector<FaceData*> subdivided_faces;
+    std::vector<FaceData*> faces;
+    std::vector<EdgeData*> edges;
+    // The face, edge and vertex points, which are the vertices of the new faces, run from refined_begin to end.
+    int refined_begin;
+    int end;
+    // The one ring of each interior vertex of the level, in [ring_offsets[v], ring_offsets[v + 1]) of rings: the other
+    // end of each adjacent edge, and then the face point of each adjacent face. Boundary vertices read their
+    // boundary_vertices instead, and have empty rings.
+    std::vector<int> ring_offsets;
+    std::vector<int> rings;
+
+    const int* OneRing(int vertex) const { return rings.data() + ring_offsets[vertex]; }
+};
+
+// Assigns the vertex buffer index of every point created by the next level, starting from first_point, and gathers the
+// one ring of each vertex.
+LevelPoints AllocateLevelPoints(int first_point,
+                                std::vector<FaceDataPtr>& face_data,
+                                std::vector<VertexData>& vertex_data);
+
+// These compute a point into the vertex buffer slot allocated for it.
+template<typename Point>
+void InsertFaceVertex(const FaceData& face, std::vector<Point>& vertex_buffer);
+template<typename Point>
+void InsertEdgeVertex(const EdgeData& edge, std::vector<Point>& vertex_buffer);
+// The vertex point of vertex, from its one ring as gathered by AllocateLevelPoints().
+template<typename Point>
+void RefineControlVertex(const VertexData& vertex, const int* one_ring, std::vector<Point>& vertex_buffer);
+
+// RefineControlVertex() goes through a kernel picked for each vertex. Interior vertices of valence 3 to 8 have kernels
+// with their valence and weights fixed at compile time, and every other vertex goes through the generic kernel, which
+// loops over a ring of any length.
+template<typename Point>
+using VertexPointKernel = void (*)(const VertexData& vertex, const int* one_ring, std::vector<Point>& vertex_buffer);
+template<typename Point>
+VertexPointKernel<Point> SelectVertexPointKernel(const VertexData& vertex);
+template<typename Point>
+void RefineControlVertexGeneric(const VertexData& vertex, const int* one_ring, std::vector<Point>& vertex_buffer);
+
+// Computes the 5x5 control points of the subpatches of each face, by splitting its 4x4 control points in half along
+// each direction. Positions go through the batched SIMD kernel in PatchKernel.h.
+template<typename Point>
+void SubdivideControlPoints(const std::vector<FaceData*>& faces, std::vector<Point>& vertex_buffer, int num_threads);
+template<>
+void SubdivideControlPoints(const std::vector<FaceData*>& faces, std::vector<glm::vec3>& vertex_buffer,
+                            int num_threads);
+template<typename Point>
+void SubdivideControlPoints(const FaceData& face, std::vector<Point>& vertex_buffer);
+template<typename Point>
+std::array<Point, 5> SplitCurve(const Point& p0, const Point& p1, const Point& p2, const Point& p3);
+
+template<typename Point>
+void CreateNewFaces(std::vector<Point>& vertex_buffer,
+                    std::vector<FaceDataPtr>& face_data,
+                    std::vector<EdgeData>& edge_data,
+                    std::vector<VertexData>& vertex_data,
+                    int num_threads,
+                    RefinementArenas* arenas = nullptr);
+std::tuple<int, int> SubpatchOffset(int face_corner);
+// The weight of each of the 16 control points in each of the 25 subpatch control points, as a dense table. The
+// separable split computes the same thing; this is kept as a reference for it.
+std::array<std::array<float, 16>, 25> GetStencilWeights();
+
+} // End namespace Subdivision
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "subdivision/TopologyRefiner.h"
+#include "subdivision/ObjMesh.h"
+#include "subdivision/Parallel.h"
+#include "subdivision/PatchKernel.h"
+
+namespace Subdivision {
+
+TopologyRefiner::TopologyRefiner(const TinyObjMesh& obj, int num_threads, const RefinementOptions& options)
+        : num_control_vertices(obj.attrs.vertices.size() / 3) {
+    std::vector<Stencil> stencil_buffer;
+    for (int i = 0; i < num_control_vertices; ++i) {
+        stencil_buffer.emplace_back(i);
+    }
+
+    // Once a stage is recorded, its points stand for themselves in the stages after it, so each stencil only holds
+    // the handful of weights of the rule which made it, instead of growing over the control vertices with each level.
+    int first_point = num_control_vertices;
+    const StageCallback<Stencil> end_stage = [this, &first_point](std::vector<Stencil>& stage_buffer) {
+        const int end_point = stage_buffer.size();
+        if (end_point == first_point) {
+            return;
+        }
+
+        const std::vector<Stencil> stage_points(stage_buffer.cbegin() + first_point, stage_buffer.cend());
+        stages.emplace_back(stage_points, first_point);
+        for (int i = first_point; i < end_point; ++i) {
+            stage_buffer[i] = Stencil{i};
+        }
+        first_point = end_point;
+    };
+
+    patches = SubdividePatches(obj, stencil_buffer, num_threads, options, end_stage);
+
+    std::vector<bool> read(num_control_vertices, false);
+    for (const auto& stage : stages) {
+        for (const int point : stage.indices) {
+            if (point < num_control_vertices) {
+                read[point] = true;
+            }
+        }
+    }
+    for (int i = 0; i < num_control_vertices; ++i) {
+        if (read[i]) {
+            read_control_vertices.push_back(i);
+        }
+    }
+}
+
+int TopologyRefiner::NumPoints() const {
+    if (stages.empty()) {
+        return num_control_vertices;
+    }
+
+    return stages.back().num_control_vertices + stages.back().NumStencils();
+}
+
+void TopologyRefiner::Refine(const std::vector<glm::vec3>& control_vertices, std::vector<glm::vec3>& refined_vertices,
+                             int num_threads) const {
+    if (static_cast<int>(control_vertices.size()) != num_control_vertices) {
+        throw std::runtime_error("Topology refiner expects " + std::to_string(num_control_vertices) +
+                                 " control vertices, but " + std::to_string(control_vertices.size()) +
+                                 " were given.");
+    }
+
+    refined_vertices.resize(NumPoints());
+    std::copy(control_vertices.cbegin(), control_vertices.cend(), refined_vertices.begin());
+
+    // The points of a stage only read the points of earlier stages, so each stage can be split across threads.
+    for (const auto& stage : stages) {
+        const int first_point = stage.num_control_vertices;
+        ParallelFor(0, stage.NumStencils(), num_threads, [&stage, &refined_vertices, first_point](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                glm::vec3 refined_vertex(0.0f);
+                for (int j = stage.offsets[i]; j < stage.offsets[i + 1]; ++j) {
+                    refined_vertex += stage.weights[j] * refined_vertices[stage.indices[j]];
+                }
+
+                refined_vertices[first_point + i] = refined_vertex;
+            }
+        });
+    }
+}
+
+void TopologyRefiner::RefineInstances(const std::vector<std::vector<glm::vec3>>& control_vertices,
+                                      std::vector<std::vector<glm::vec3>>& refined_vertices, int num_threads) const {
+    for (const auto& instance : control_vertices) {
+        if (static_cast<int>(instance.size()) != num_control_vertices) {
+            throw std::runtime_error("Topology refiner expects " + std::to_string(num_control_vertices) +
+                                     " control vertices, but an instance has " + std::to_string(instance.size()) +
+                                     ".");
+        }
+    }
+
+    const int num_instances = control_vertices.size();
+    refined_vertices.resize(num_instances);
+    for (auto& instance : refined_vertices) {
+        instance.resize(NumPoints());
+    }
+
+    // Lanes past the last instance of the last batch are refined from zeros and thrown away.
+    std::vector<InstanceBatchPoint> batch(NumPoints());
+    for (int first_instance = 0; first_instance < num_instances; first_instance += patch_batch_size) {
+        const int batch_size = std::min(patch_batch_size, num_instances - first_instance);
+        // Only the control vertices the stages read go into the batch.
+        ParallelFor(0, read_control_vertices.size(), num_threads, [&](int begin, int end) {
+            for (int l = 0; l < patch_batch_size; ++l) {
+                for (int r = begin; r < end; ++r) {
+                    const int i = read_control_vertices[r];
+                    const glm::vec3 point = (l < batch_size) ? control_vertices[first_instance + l][i] : glm::vec3{};
+                    for (int c = 0; c < 3; ++c) {
+                        batch[i].coords[c][l] = point[c];
+                    }
+                }
+            }
+        });
+
+        for (const auto& stage : stages) {
+            ParallelFor(0, stage.NumStencils(), num_threads, [&stage, &batch](int begin, int end) {
+                ApplyStencilBatch(stage, begin, end, stage.num_control_vertices, batch);
+            });
+        }
+
+        // The control vertices are copied straight from the input.
+        ParallelFor(0, NumPoints(), num_threads, [&](int begin, int end) {
+            for (int l = 0; l < batch_size; ++l) {
+                const std::vector<glm::vec3>& controls = control_vertices[first_instance + l];
+                std::vector<glm::vec3>& instance = refined_vertices[first_instance + l];
+                for (int i = begin; i < std::min(end, num_control_vertices); ++i) {
+                    instance[i] = controls[i];
+                }
+                for (int i = std::max(begin, num_control_vertices); i < end; ++i) {
+                    instance[i] = glm::vec3{batch[i].coords[0][l], batch[i].coords[1][l], batch[i].coords[2][l]};
+                }
+            }
+        });
+    }
+}
+
+IndexedMesh TopologyRefiner::RefineMesh(const std::vector<glm::vec3>& control_vertices, int num_threads) const {
+    std::vector<glm::vec3> refined_vertices;
+    Refine(control_vertices, refined_vertices, num_threads);
+    std::vector<PatchBounds> patch_bounds{ComputePatchBounds(refined_vertices, patches.indices, num_threads)};
+
+    return {std::move(refined_vertices), patches.indices, std::move(patch_bounds), patches.flags, patches.levels};
+}
+
+} // End namespace Subdivision
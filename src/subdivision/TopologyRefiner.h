@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "subdivision/Stencil.h"
+#include "subdivision/Subdivision.h"
+
+namespace Subdivision {
+
+struct TinyObjMesh;
+struct IndexedMesh;
+
+// The refinement of a control mesh, worked out once from its connectivity and then run on any number of sets of
+// control vertex positions: every frame of an animation, or every character of a crowd sharing one cage. Building it
+// does all the topology work of SubdivideMesh(), the connectivity, the maps and the end caps, and records how each
+// point of each stage is computed from the points before it. Refining a set of positions is then only weighted sums.
+class TopologyRefiner {
+public:
+    TopologyRefiner(const TinyObjMesh& obj_data, int num_threads = 1, const RefinementOptions& options = {});
+
+    int NumControlVertices() const { return num_control_vertices; }
+    // The size of the vertex buffer after refinement, control vertices included.
+    int NumPoints() const;
+    // 16 indices into the refined vertex buffer per B-spline patch, the same for every set of positions.
+    const std::vector<int>& Indices() const { return patches.indices; }
+    const PatchTable& Patches() const { return patches; }
+
+    // Fills refined_vertices with the control vertices followed by every point the refinement adds, in the same order
+    // as SubdivideMesh(). Only allocates the first time a buffer is used with this refiner.
+    void Refine(const std::vector<glm::vec3>& control_vertices, std::vector<glm::vec3>& refined_vertices,
+                int num_threads = 1) const;
+    // Refines many instances of the mesh at once, such as the characters of a crowd in their own poses: fills
+    // refined_vertices[n] from control_vertices[n] as Refine() would, with the same bits. The instances are refined in
+    // batches of patch_batch_size, one per SIMD lane, so each weight is loaded once per batch instead of per instance.
+    void RefineInstances(const std::vector<std::vector<glm::vec3>>& control_vertices,
+                         std::vector<std::vector<glm::vec3>>& refined_vertices, int num_threads = 1) const;
+    // The same output as SubdivideMesh() for the given positions, up to rounding.
+    IndexedMesh RefineMesh(const std::vector<glm::vec3>& control_vertices, int num_threads = 1) const;
+
+private:
+    int num_control_vertices;
+    // One table per stage of the refinement, over the points before it. The first point a stage reads past is its
+    // own first point, so num_control_vertices of each table is also where its points go.
+    std::vector<StencilTable> stages;
+    // The control vertices any stage reads, which RefineInstances() gathers into its batches.
+    std::vector<int> read_control_vertices;
+    PatchTable patches;
+};
+
+} // End namespace Subdivision